@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#ifndef EPSILON_INC_ARENA_HPP
+#define EPSILON_INC_ARENA_HPP
+
+// std
+#include <concepts>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// epx
+#include "t.hpp"
+
+namespace epx {
+
+namespace details {
+
+// Resource of the innermost arena_scope on this thread, or nullptr outside of any scope.
+inline std::pmr::memory_resource*& current_arena() noexcept {
+  thread_local std::pmr::memory_resource* res = nullptr;
+  return res;
+}
+
+}  // namespace details
+
+// Allocator that binds, when constructed, to the innermost arena_scope of the calling thread, or to
+// the default memory resource outside of any scope. Copy construction rebinds to the current scope
+// and assignment never transfers the allocator, so copying or assigning a value to a z created
+// outside a scope moves its digits out of the arena. Move construction keeps the arena: a value
+// built inside a scope must be copied, not moved, to outlive it.
+template <class T>
+class arena_allocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+  using is_always_equal = std::false_type;
+
+  arena_allocator() noexcept
+      : res_(details::current_arena() ? details::current_arena() : std::pmr::get_default_resource()) {}
+  explicit arena_allocator(std::pmr::memory_resource* res) noexcept : res_(res) {}
+  template <class U>
+  arena_allocator(const arena_allocator<U>& other) noexcept : res_(other.resource()) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(res_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T* p, size_t n) noexcept { res_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+  arena_allocator select_on_container_copy_construction() const noexcept { return arena_allocator{}; }
+
+  std::pmr::memory_resource* resource() const noexcept { return res_; }
+
+  template <class U>
+  friend bool operator==(const arena_allocator& lhs, const arena_allocator<U>& rhs) noexcept {
+    return *lhs.resource() == *rhs.resource();
+  }
+
+ private:
+  std::pmr::memory_resource* res_;
+};
+
+// Digit container for z whose storage comes from the current arena_scope.
+template <class D>
+using arena_vector = std::vector<D, arena_allocator<D>>;
+
+// Installs a memory resource as the current arena of the calling thread until destruction, then
+// restores the previous one. The default constructor owns a monotonic buffer, so every digit
+// allocated within the scope is released at once when it ends. Scopes nest; each one draws from
+// the default memory resource, not from the enclosing arena, so that a short inner scope returns
+// its memory before the outer one ends. No z<arena_vector<D>> created inside a scope may outlive it.
+class arena_scope {
+ public:
+  arena_scope() : arena_scope(std::in_place) {}
+  explicit arena_scope(size_t initial_size) : arena_scope(std::in_place, initial_size) {}
+  explicit arena_scope(std::pmr::memory_resource* res) noexcept
+      : res_(res), prev_(std::exchange(details::current_arena(), res)) {}
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  ~arena_scope() { details::current_arena() = prev_; }
+
+  std::pmr::memory_resource* resource() const noexcept { return res_; }
+
+ private:
+  template <class... Args>
+  explicit arena_scope(std::in_place_t, Args... args)
+      : pool_(std::in_place, args..., std::pmr::get_default_resource()),
+        res_(&*pool_),
+        prev_(std::exchange(details::current_arena(), res_)) {}
+
+  std::optional<std::pmr::monotonic_buffer_resource> pool_;
+  std::pmr::memory_resource* res_;
+  std::pmr::memory_resource* prev_;
+};
+
+namespace details {
+
+template <class C>
+concept arena_container = std::same_as<typename C::allocator_type, arena_allocator<typename C::value_type>>;
+
+// Evaluates f, a kernel returning z<C>. For arena containers its temporaries come from a scratch
+// arena that is released when f returns; the result is copied out first. The arena is a pool, not
+// a monotonic buffer: a series kernel frees the temporaries of each term before the next, and the
+// pool hands their blocks out again, so that its peak stays near the working set of one term.
+template <container C, class F>
+z<C> with_scratch_arena(F&& f) {
+  if constexpr (arena_container<C>) {
+    z<C> res;
+    {
+      std::pmr::unsynchronized_pool_resource pool;
+      arena_scope scope(&pool);
+      const z<C> v = std::forward<F>(f)();
+      res = v;
+    }
+    return res;
+  } else {
+    return std::forward<F>(f)();
+  }
+}
+
+}  // namespace details
+
+}  // namespace epx
+
+#endif  // EPSILON_INC_ARENA_HPP
@@ -6,6 +6,7 @@
 
 // std
 #include <cctype>
+#include <limits>
 #include <optional>
 #include <string_view>
 
@@ -68,17 +69,29 @@ constexpr std::string to_string(z<C> num) {
       return "0";
     }
 
+    using D = typename z<C>::digit_type;
+    // Each pass divides by the largest power of 10 that fits in a digit and emits its decimals.
+    constexpr auto chunk = [] {
+      struct {
+        D pow = 10;
+        int len = 1;
+      } c;
+      while (c.pow <= std::numeric_limits<D>::max() / 10) {
+        c.pow = static_cast<D>(c.pow * 10);
+        ++c.len;
+      }
+      return c;
+    }();
+
     std::string res;
     sign sgn = num.sgn;
-    const z<C> ten = {.digits = {10}};
     while (!is_zero(num)) {
-      auto [q, r] = div_n(num, ten);
-      if (is_zero(r)) {
-        res.push_back('0');
-      } else {
-        res.push_back(static_cast<char>(r.digits[0]) + '0');
+      D r = details::div_1(num, num, chunk.pow);
+      normalize(num);
+      for (int i = 0; i < chunk.len && (r != 0 || !is_zero(num)); ++i) {
+        res.push_back(static_cast<char>('0' + r % 10));
+        r = static_cast<D>(r / 10);
       }
-      num = std::exchange(q, {});
     }
     if (sgn == sign::negative) {
       res.push_back('-');
@@ -123,4 +136,14 @@ constexpr std::string to_string(r<C> num, unsigned int k) {
 
 }  // namespace epx
 
+#if defined(EPSILON_EXTERN_TEMPLATE)
+namespace epx {
+
+EPSILON_EXTERN_TEMPLATE std::optional<z<>> try_from_chars<default_container_type>(std::string_view);
+EPSILON_EXTERN_TEMPLATE std::string to_string(z<>);
+EPSILON_EXTERN_TEMPLATE std::string to_string(r<default_container_type>, unsigned int);
+
+}  // namespace epx
+#endif
+
 #endif  // EPSILON_INC_CHARS_HPP
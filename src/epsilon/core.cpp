@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#include "core.hpp"
+
+// std
+#include <algorithm>
+#include <span>
+
+// x86-64 builds carry BMI2/ADX variants of the limb kernels, compiled by GCC or Clang.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EPSILON_HAS_ISA_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+// epx
+#include "chars.hpp"
+#include "r.hpp"
+#include "z.hpp"
+
+namespace epx::core {
+
+namespace {
+
+using D = limb_kernels::digit_type;
+
+D addmul_1_baseline(D* r, const D* a, size_t n, D v) { return details::addmul_1_limbs_generic<D>({r, n}, {a, n}, v); }
+
+void mul_basecase_baseline(D* r, const D* a, size_t an, const D* b, size_t bn) {
+  details::mul_basecase_generic<D>({r, an + bn}, {a, an}, {b, bn});
+}
+
+void sqr_basecase_baseline(D* r, const D* a, size_t n) { details::sqr_basecase_generic<D>({r, 2 * n}, {a, n}); }
+
+constexpr limb_kernels baseline_kernels{.level = isa::baseline,
+                                        .addmul_1 = addmul_1_baseline,
+                                        .mul_basecase = mul_basecase_baseline,
+                                        .sqr_basecase = sqr_basecase_baseline};
+
+#if defined(EPSILON_HAS_ISA_DISPATCH)
+// The basecase variants run the rows of the schoolbook product through addmul_1_adx, and inline
+// the rest of the portable loops into functions compiled for BMI2 and ADX.
+#define EPSILON_TARGET_BMI2_ADX "bmi,bmi2,adx"
+
+static_assert(sizeof(D) == sizeof(uint64_t));
+
+// r += a * v with mulx and two carry chains that run side by side: adox carries the high half of
+// each product into the low half of the next, adcx adds the sums into r. Four digits per step, after
+// which both chains are folded into the carry digit, so that the loop control may clobber the flags.
+[[gnu::target(EPSILON_TARGET_BMI2_ADX)]] D addmul_1_adx(D* r, const D* a, size_t n, D v) {
+  D cy = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    D lo0, hi0, lo1, zero;
+    __asm__(
+        "xor %k[zero], %k[zero]\n\t"
+        "mulx (%[a]), %[lo0], %[hi0]\n\t"
+        "adox %[cy], %[lo0]\n\t"
+        "adcx (%[r]), %[lo0]\n\t"
+        "mov %[lo0], (%[r])\n\t"
+        "mulx 8(%[a]), %[lo1], %[cy]\n\t"
+        "adox %[hi0], %[lo1]\n\t"
+        "adcx 8(%[r]), %[lo1]\n\t"
+        "mov %[lo1], 8(%[r])\n\t"
+        "mulx 16(%[a]), %[lo0], %[hi0]\n\t"
+        "adox %[cy], %[lo0]\n\t"
+        "adcx 16(%[r]), %[lo0]\n\t"
+        "mov %[lo0], 16(%[r])\n\t"
+        "mulx 24(%[a]), %[lo1], %[cy]\n\t"
+        "adox %[hi0], %[lo1]\n\t"
+        "adcx 24(%[r]), %[lo1]\n\t"
+        "mov %[lo1], 24(%[r])\n\t"
+        "adox %[zero], %[cy]\n\t"
+        "adcx %[zero], %[cy]"
+        : [cy] "+&r"(cy), [lo0] "=&r"(lo0), [hi0] "=&r"(hi0), [lo1] "=&r"(lo1), [zero] "=&r"(zero)
+        : [a] "r"(a + i), [r] "r"(r + i), "d"(v)
+        : "cc", "memory");
+  }
+  for (; i < n; ++i) {
+    auto [p0, p1] = details::umul(a[i], v);
+    p1 += details::addcarry(0, p0, cy, &p0);
+    cy = p1 + details::addcarry(0, r[i], p0, &r[i]);
+  }
+  return cy;
+}
+
+inline void mul_rows_adx(D* r, const D* a, size_t an, const D* b, size_t bn) {
+  std::fill_n(r, an, D{0});
+  for (size_t j = 0; j < bn; ++j) r[j + an] = addmul_1_adx(r + j, a, an, b[j]);
+}
+
+inline void sqr_rows_adx(D* r, const D* a, size_t n) {
+  std::fill_n(r, 2 * n, D{0});
+  for (size_t i = 0; i + 1 < n; ++i) r[i + n] = addmul_1_adx(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+  details::add_sqr_diagonal<D>({r, 2 * n}, {a, n});
+}
+
+[[gnu::flatten, gnu::target(EPSILON_TARGET_BMI2_ADX)]] void mul_basecase_bmi2_adx(D* r, const D* a, size_t an,
+                                                                               const D* b, size_t bn) {
+  mul_rows_adx(r, a, an, b, bn);
+}
+
+[[gnu::flatten, gnu::target(EPSILON_TARGET_BMI2_ADX)]] void sqr_basecase_bmi2_adx(D* r, const D* a, size_t n) {
+  sqr_rows_adx(r, a, n);
+}
+
+constexpr limb_kernels bmi2_adx_kernels{.level = isa::bmi2_adx,
+                                        .addmul_1 = addmul_1_adx,
+                                        .mul_basecase = mul_basecase_bmi2_adx,
+                                        .sqr_basecase = sqr_basecase_bmi2_adx};
+
+// Highest level that cpuid reports.
+isa detect() noexcept {
+  unsigned a, b, c, d;
+  if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) {
+    return isa::baseline;
+  }
+  constexpr unsigned bmi2_adx = bit_BMI | bit_BMI2 | bit_ADX;
+  return (b & bmi2_adx) == bmi2_adx ? isa::bmi2_adx : isa::baseline;
+}
+#endif
+
+// True when the host CPU runs the given level.
+bool supports(isa level) noexcept {
+#if defined(EPSILON_HAS_ISA_DISPATCH)
+  static const isa host = detect();
+  return level <= host;
+#else
+  return level == isa::baseline;
+#endif
+}
+
+}  // namespace
+
+const limb_kernels* kernels(isa level) noexcept {
+  if (!supports(level)) {
+    return nullptr;
+  }
+  switch (level) {
+    case isa::baseline:
+      return &baseline_kernels;
+#if defined(EPSILON_HAS_ISA_DISPATCH)
+    case isa::bmi2_adx:
+      return &bmi2_adx_kernels;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const limb_kernels& kernels() noexcept {
+  static const limb_kernels& selected = *(supports(isa::bmi2_adx) ? kernels(isa::bmi2_adx) : &baseline_kernels);
+  return selected;
+}
+
+namespace {
+
+// Installs the selected kernels before main, so that the span kernels load a pointer instead of
+// testing the guard of kernels() on every row.
+[[maybe_unused]] const bool kernels_installed = (active_kernels = &kernels(), true);
+
+}  // namespace
+
+}  // namespace epx::core
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#ifndef EPSILON_INC_CORE_HPP
+#define EPSILON_INC_CORE_HPP
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+// epx
+#include "t.hpp"
+
+// Explicit instantiations for default_container_type live in the compiled epsilon_core library,
+// which defines EPSILON_CORE for the targets linking it. The headers declare them extern there, and
+// core.cpp, which also defines EPSILON_CORE_INSTANTIATE, defines them. EPSILON_CORE changes nothing
+// else, so translation units built with and without it may share a program.
+#if defined(EPSILON_CORE_INSTANTIATE)
+#define EPSILON_EXTERN_TEMPLATE template
+#elif defined(EPSILON_CORE)
+#define EPSILON_EXTERN_TEMPLATE extern template
+#endif
+
+namespace epx::core {
+
+// Instruction set levels of the limb kernels: x86-64 baseline, and BMI2 (mulx) with ADX (adcx,
+// adox) on top of it.
+enum class isa : uint8_t { baseline, bmi2_adx };
+
+// Limb kernels for default_digit_type, compiled for one instruction set level.
+struct limb_kernels {
+  using digit_type = default_digit_type;
+
+  isa level;
+  // r += a * v, where |r| == |a| == n. Returns the carry out of r.
+  digit_type (*addmul_1)(digit_type* r, const digit_type* a, size_t n, digit_type v);
+  // r = a * b, where |r| == an + bn and r does not overlap a or b.
+  void (*mul_basecase)(digit_type* r, const digit_type* a, size_t an, const digit_type* b, size_t bn);
+  // r = a^2, where |r| == 2 * n and r does not overlap a.
+  void (*sqr_basecase)(digit_type* r, const digit_type* a, size_t n);
+};
+
+// The kernels the span kernels in z.hpp call at run time for default_digit_type digits. Null, which
+// keeps the portable loops, unless the program links epsilon_core, whose static initialization
+// installs kernels().
+inline constinit const limb_kernels* active_kernels = nullptr;
+
+// The kernels of the highest level that both the library and the host CPU support, selected on first
+// use by cpuid.
+const limb_kernels& kernels() noexcept;
+
+// The kernels of the given level, or nullptr unless the library carries them and the host CPU runs
+// them.
+const limb_kernels* kernels(isa level) noexcept;
+
+}  // namespace epx::core
+
+#endif  // EPSILON_INC_CORE_HPP
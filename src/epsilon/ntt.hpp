@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#ifndef EPSILON_INC_NTT_HPP
+#define EPSILON_INC_NTT_HPP
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Number-theoretic transforms over three word-sized primes, used by the multiplication kernels in
+// z.hpp. Coefficients are 32-bit chunks of the operands; a cyclic convolution of length n is
+// computed modulo each prime and recombined by the Chinese remainder theorem (Garner's algorithm).
+namespace epx::details::ntt {
+
+// p = k * 2^e + 1, with a primitive root g. All primes support transforms of length up to 2^26.
+struct prime {
+  uint32_t p;
+  uint32_t g;
+};
+inline constexpr prime p1 = {.p = 2013265921, .g = 31};  // 15 * 2^27 + 1
+inline constexpr prime p2 = {.p = 1811939329, .g = 13};  // 27 * 2^26 + 1
+inline constexpr prime p3 = {.p = 469762049, .g = 3};    // 7 * 2^26 + 1
+
+// Longest supported transform. A convolution term is at most 2^25 * (2^32 - 1)^2 < 2^89, which is
+// below p1 * p2 * p3 > 2^90, so the CRT reconstruction is exact up to this length.
+inline constexpr size_t max_length = size_t{1} << 26;
+
+template <uint32_t P>
+constexpr uint32_t mul_mod(uint32_t a, uint32_t b) {
+  return static_cast<uint32_t>(uint64_t{a} * b % P);
+}
+
+template <uint32_t P>
+constexpr uint32_t pow_mod(uint32_t a, uint64_t e) {
+  uint32_t r = 1;
+  while (e > 0) {
+    if (e & 1) r = mul_mod<P>(r, a);
+    a = mul_mod<P>(a, a);
+    e >>= 1;
+  }
+  return r;
+}
+
+// In-place radix-2 transform of a (|a| is a power of two), or its inverse including the 1/n scale.
+template <prime Q>
+constexpr void dft(std::span<uint32_t> a, bool inverse) {
+  constexpr uint32_t P = Q.p;
+  const size_t n = a.size();
+  assert(n > 0 && (n & (n - 1)) == 0 && n <= max_length);
+
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+
+  std::vector<uint32_t> tw(n / 2);
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const size_t half = len / 2;
+    uint32_t w = pow_mod<P>(Q.g, (P - 1) / len);
+    if (inverse) w = pow_mod<P>(w, P - 2);
+    tw[0] = 1;
+    for (size_t j = 1; j < half; ++j) tw[j] = mul_mod<P>(tw[j - 1], w);
+    for (size_t i = 0; i < n; i += len) {
+      for (size_t j = 0; j < half; ++j) {
+        uint32_t u = a[i + j];
+        uint32_t v = mul_mod<P>(a[i + j + half], tw[j]);
+        a[i + j] = u + v >= P ? u + v - P : u + v;
+        a[i + j + half] = u >= v ? u - v : u + P - v;
+      }
+    }
+  }
+
+  if (inverse) {
+    const uint32_t inv_n = pow_mod<P>(static_cast<uint32_t>(n % P), P - 2);
+    for (auto& x : a) x = mul_mod<P>(x, inv_n);
+  }
+}
+
+// Transform of a, zero-padded to length n, modulo Q.p.
+template <prime Q>
+constexpr std::vector<uint32_t> forward(std::span<const uint32_t> a, size_t n) {
+  std::vector<uint32_t> fa(n);
+  for (size_t i = 0; i < a.size(); ++i) fa[i] = a[i] % Q.p;
+  dft<Q>(fa, false);
+  return fa;
+}
+
+// Cyclic convolution of a and b modulo Q.p, with transform length n >= |a| + |b| - 1. A square
+// (a and b are the same sequence) needs one forward transform instead of two.
+template <prime Q>
+constexpr std::vector<uint32_t> convolve(std::span<const uint32_t> a, std::span<const uint32_t> b, size_t n) {
+  auto fa = forward<Q>(a, n);
+  if (a.data() == b.data() && a.size() == b.size()) {
+    for (auto& x : fa) x = mul_mod<Q.p>(x, x);
+  } else {
+    const auto fb = forward<Q>(b, n);
+    for (size_t i = 0; i < n; ++i) fa[i] = mul_mod<Q.p>(fa[i], fb[i]);
+  }
+  dft<Q>(fa, true);
+  return fa;
+}
+
+// Cyclic convolution of a and the sequence with transform fb modulo Q.p, of length |fb|.
+template <prime Q>
+constexpr std::vector<uint32_t> convolve(std::span<const uint32_t> a, std::span<const uint32_t> fb) {
+  auto fa = forward<Q>(a, fb.size());
+  for (size_t i = 0; i < fa.size(); ++i) fa[i] = mul_mod<Q.p>(fa[i], fb[i]);
+  dft<Q>(fa, true);
+  return fa;
+}
+
+// Smallest transform length for a product of na and nb coefficients.
+constexpr size_t length(size_t na, size_t nb) {
+  size_t n = 1;
+  while (n < na + nb - 1) n <<= 1;
+  return n;
+}
+
+// Transforms of a fixed operand modulo the three primes, of length n, and its number of
+// coefficients. It multiplies any operand of at most n - size + 1 coefficients.
+struct transform {
+  size_t n = 0;
+  size_t size = 0;
+  std::vector<uint32_t> f1, f2, f3;
+};
+
+constexpr transform prepare(std::span<const uint32_t> b, size_t n) {
+  assert(n <= max_length);
+  return {.n = n, .size = b.size(), .f1 = forward<p1>(b, n), .f2 = forward<p2>(b, n), .f3 = forward<p3>(b, n)};
+}
+
+// Writes the product with the convolutions c1, c2 and c3 modulo the three primes to r, as 32-bit
+// chunks. |r| may be shorter than the product as long as the dropped high chunks are zero.
+constexpr void recombine(std::span<uint32_t> r, std::span<const uint32_t> c1, std::span<const uint32_t> c2,
+                         std::span<const uint32_t> c3) {
+  const size_t n = c1.size();
+
+  // Garner: x = t1 + t2 * p1 + t3 * p1 * p2, with t1 < p1, t2 < p2 and t3 < p3.
+  constexpr uint32_t inv_p1_p2 = pow_mod<p2.p>(p1.p % p2.p, p2.p - 2);
+  constexpr uint32_t inv_p1_p3 = pow_mod<p3.p>(p1.p % p3.p, p3.p - 2);
+  constexpr uint32_t inv_p2_p3 = pow_mod<p3.p>(p2.p % p3.p, p3.p - 2);
+  constexpr uint64_t p1p2 = uint64_t{p1.p} * p2.p;
+
+  uint64_t cy = 0;  // carry into the current chunk, always below 2^60
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t t1 = c1[i];
+    const uint32_t t2 = mul_mod<p2.p>((c2[i] + p2.p - t1 % p2.p) % p2.p, inv_p1_p2);
+    uint32_t t3 = mul_mod<p3.p>((c3[i] + p3.p - t1 % p3.p) % p3.p, inv_p1_p3);
+    t3 = mul_mod<p3.p>((t3 + p3.p - t2 % p3.p) % p3.p, inv_p2_p3);
+
+    // (hi, lo) = t3 * p1p2 + t2 * p1 + t1 + cy, as a 128-bit value.
+    const uint64_t m0 = (p1p2 & 0xffffffff) * t3;
+    const uint64_t m1 = (p1p2 >> 32) * t3 + (m0 >> 32);
+    uint64_t lo = (m0 & 0xffffffff) | (m1 << 32);
+    uint64_t hi = m1 >> 32;
+    const uint64_t low = uint64_t{t2} * p1.p + t1;
+    lo += low;
+    hi += lo < low;
+    lo += cy;
+    hi += lo < cy;
+
+    if (i < r.size()) {
+      r[i] = static_cast<uint32_t>(lo);
+    } else {
+      assert(static_cast<uint32_t>(lo) == 0);
+    }
+    cy = (lo >> 32) | (hi << 32);
+  }
+  for (size_t i = n; i < r.size(); ++i) {
+    r[i] = static_cast<uint32_t>(cy);
+    cy >>= 32;
+  }
+  assert(cy == 0);
+}
+
+// Full product of the 32-bit chunk sequences a and b, written to r as 32-bit chunks. |r| may be
+// shorter than |a| + |b| as long as the dropped high chunks of the product are zero.
+constexpr void multiply(std::span<uint32_t> r, std::span<const uint32_t> a, std::span<const uint32_t> b) {
+  const size_t n = length(a.size(), b.size());
+  assert(n <= max_length);
+  recombine(r, convolve<p1>(a, b, n), convolve<p2>(a, b, n), convolve<p3>(a, b, n));
+}
+
+// Full product of a and the operand prepared in tb, as multiply. Takes two transforms per prime
+// instead of three.
+constexpr void multiply(std::span<uint32_t> r, std::span<const uint32_t> a, const transform& tb) {
+  assert(a.size() + tb.size - 1 <= tb.n);
+  recombine(r, convolve<p1>(a, tb.f1), convolve<p2>(a, tb.f2), convolve<p3>(a, tb.f3));
+}
+
+}  // namespace epx::details::ntt
+
+#endif  // EPSILON_INC_NTT_HPP
@@ -8,8 +8,11 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <optional>
+#include <utility>
 
 // epx
+#include "arena.hpp"
 #include "coro.hpp"
 #include "z.hpp"
 
@@ -38,9 +41,22 @@ class r {
 
 template <container C>
 constexpr r<C> make_q(z<C> p, z<C> q) {
-  return r<C>{[p = std::move(p), q = std::move(q)](int n) -> coro::lazy<z<C>> {
+  // in lowest terms, so that every approximation divides the shortest operands
+  if (!is_zero(q)) {
+    const auto g = gcd(p, q);
+    if (g != details::one<C>()) {
+      p = div(p, g).q;
+      q = div(q, g).q;
+    }
+  }
+  // a zero denominator is reported by the first approximation, like the other operations
+  auto d = is_zero(q) ? std::optional<divisor<C>>{} : std::optional<divisor<C>>{std::in_place, std::move(q)};
+  return r<C>{[p = std::move(p), q = std::move(d)](int n) -> coro::lazy<z<C>> {
+    if (!q) [[unlikely]] {
+      throw divide_by_zero_error{};
+    }
     auto rr = mul_4exp(p, n);
-    auto [quo, _] = floor_div(rr, q);
+    auto [quo, _] = floor_div(rr, *q);
     co_return quo;  // q (n) = floor(p * 4^n / q)
   }};
 }
@@ -168,6 +184,29 @@ namespace details {
 
 constexpr int exp_guard = 12;
 
+// Fixed-point multiply: dst = a * b / 4^prec, rounded toward zero or one unit short of it in
+// magnitude, reusing the storage of dst. Only the top of the product is computed; the guard digits
+// of the callers absorb the unit. dst must not be a or b, so loops alternate between two buffers.
+template <container C>
+constexpr z<C>& fp_mul_into(z<C>& dst, const z<C>& a, const z<C>& b, int prec) {
+  return mul_high_into(dst, a, b, 2 * prec);
+}
+
+// Fixed-point multiply: a * b / 4^prec, as fp_mul_into
+template <container C>
+constexpr z<C> fp_mul(const z<C>& a, const z<C>& b, int prec) {
+  z<C> prod;
+  fp_mul_into(prod, a, b, prec);
+  return prod;
+}
+
+// Fixed-point multiply by a prepared multiplier, as fp_mul_into, for series that multiply by the
+// same power on every term.
+template <container C>
+constexpr z<C>& fp_mul_into(z<C>& dst, const z<C>& a, const prepared_multiplier<C>& b, int prec) {
+  return mul_high_into(dst, a, b, 2 * prec);
+}
+
 // Compute floor(exp(frac / 4^k) * 4^p) via Taylor series.
 // Requires: frac <= 0 and |frac| <= 4^k (i.e., frac/4^k in [-1, 0]).
 template <container C>
@@ -180,19 +219,16 @@ constexpr z<C> exp_taylor(const z<C>& frac, int k, int p) {
     return mul_4exp(one<C>(), p);
   }
 
-  auto denom = mul_4exp(one<C>(), k);  // 4^k
+  z<C> prod;
   for (int i = 1;; ++i) {
     // term = term * frac / (i * 4^k)  (signed: frac may be negative)
-    auto i_z = create<C>(i);
-    auto divisor = mul_4exp(i_z, k);
-    term = mul(term, frac);
-    auto [q, _] = floor_div(term, divisor);
-    term = std::move(q);
+    fp_mul_into(prod, term, frac, k);
+    floor_div_si(term, prod, i);
 
     if (is_zero(term)) {
       break;
     }
-    sum = add(sum, term);
+    add_to(sum, sum, term);
   }
 
   // shift from wp back to p
@@ -207,24 +243,16 @@ constexpr z<C> compute_e(int p) {
   auto term = sum;
 
   for (int i = 1;; ++i) {
-    auto [q, _] = floor_div(term, create<C>(i));
-    term = std::move(q);
+    floor_div_si(term, term, i);
     if (is_zero(term)) {
       break;
     }
-    sum = add_n(sum, term);
+    add_to(sum, sum, term);
   }
 
   return mul_4exp(sum, -(exp_guard));
 }
 
-// Fixed-point multiply: floor(a * b / 4^prec)
-template <container C>
-constexpr z<C> fp_mul(const z<C>& a, const z<C>& b, int prec) {
-  auto prod = mul(a, b);
-  return mul_4exp(prod, -prec);
-}
-
 // Binary exponentiation in fixed-point: compute floor(base^exp * 4^prec)
 // base is a fixed-point value at precision prec (i.e., represents base / 4^prec).
 template <container C>
@@ -234,14 +262,17 @@ constexpr z<C> fp_pow(const z<C>& base, int exp, int prec) {
 
   auto result = mul_4exp(one<C>(), prec);
   auto b = base;
+  z<C> t;
   int e = exp;
   while (e > 0) {
     if (e & 1) {
-      result = fp_mul<C>(result, b, prec);
+      fp_mul_into(t, result, b, prec);
+      std::swap(result, t);
     }
     e >>= 1;
     if (e > 0) {
-      b = fp_mul<C>(b, b, prec);
+      fp_mul_into(t, b, b, prec);
+      std::swap(b, t);
     }
   }
   return result;
@@ -275,9 +306,9 @@ constexpr z<C> exp_rational(z<C> num, int k, int p) {
         // Simple extraction for small values
         auto tmp = m_abs;
         while (!is_zero(tmp)) {
-          auto [qt, r] = div_n(tmp, ten<C>());
-          m_str.push_back(is_zero(r) ? '0' : static_cast<char>(r.digits[0]) + '0');
-          tmp = std::move(qt);
+          const auto r = div_1(tmp, tmp, typename z<C>::digit_type{10});
+          normalize(tmp);
+          m_str.push_back(static_cast<char>('0' + r));
         }
         std::ranges::reverse(m_str);
       }
@@ -336,18 +367,19 @@ constexpr z<C> log_near_one_plus(int n, int prec) {
   auto z_pow = sum;                       // z^1 in fixed-point
   auto z_fp = sum;                        // z in fixed-point
 
+  z<C> term;
   for (int i = 2;; ++i) {
     // z_pow = z_pow * z / 4^wp (but z = 1/4^n, so z_pow * 1/4^n)
-    z_pow = mul_4exp(z_pow, -n);
+    mul_4exp(z_pow, -n);
     if (is_zero(z_pow)) break;
 
-    auto [term, _] = floor_div(z_pow, create<C>(i));
+    floor_div_si(term, z_pow, i);
     if (is_zero(term)) break;
 
     if (i % 2 == 0) {
-      sum = sub(sum, term);  // even terms are subtracted
+      sub_to(sum, sum, term);  // even terms are subtracted
     } else {
-      sum = add(sum, term);  // odd terms are added
+      add_to(sum, sum, term);  // odd terms are added
     }
   }
 
@@ -375,15 +407,16 @@ constexpr z<C> log_near_one_minus(int n, int prec) {
   auto sum = zero<C>();
   auto z_pow = mul_4exp(one<C>(), wp - n);  // z^1 in fixed-point
 
+  z<C> term;
   for (int i = 1;; ++i) {
     if (is_zero(z_pow)) break;
-    auto [term, _] = floor_div(z_pow, create<C>(i));
+    floor_div_si(term, z_pow, i);
     if (is_zero(term)) break;
 
-    sum = add_n(sum, term);  // accumulate |terms|
+    add_to(sum, sum, term);  // accumulate |terms|
 
     // z_pow *= z = z_pow / 4^n
-    z_pow = mul_4exp(z_pow, -n);
+    mul_4exp(z_pow, -n);
   }
 
   // result is -sum
@@ -426,9 +459,9 @@ constexpr int compute_d(int c, int msd_x, int p) {
     tmp.sgn = sign::positive;
     std::string s;
     while (!is_zero(tmp)) {
-      auto [qt, rm] = div_n(tmp, ten<C>());
-      s.push_back(is_zero(rm) ? '0' : static_cast<char>(rm.digits[0]) + '0');
-      tmp = std::move(qt);
+      const auto rm = div_1(tmp, tmp, typename z<C>::digit_type{10});
+      normalize(tmp);
+      s.push_back(static_cast<char>('0' + rm));
     }
     std::ranges::reverse(s);
     for (char ch : s) d_val = d_val * 10 + (ch - '0');
@@ -452,18 +485,20 @@ template <container C>
 constexpr z<C> compute_ln2(int prec) {
   if (prec < 0) return zero<C>();
   const int wp = prec + log_guard;
-  auto [z_fp, _] = floor_div(mul_4exp(one<C>(), wp), create<C>(3));
+  auto z_fp = mul_4exp(one<C>(), wp);
+  floor_div_si(z_fp, z_fp, 3);
   if (is_zero(z_fp)) return zero<C>();
-  auto z2 = fp_mul<C>(z_fp, z_fp, wp);
+  const prepared_multiplier<C> z2(fp_mul<C>(z_fp, z_fp, wp));
   auto sum = z_fp;
   auto z_pow = z_fp;
+  z<C> t, term;
   for (int i = 1;; ++i) {
-    z_pow = fp_mul<C>(z_pow, z2, wp);
+    fp_mul_into(t, z_pow, z2, wp);
+    std::swap(z_pow, t);
     if (is_zero(z_pow)) break;
-    auto denom = create<C>(2 * i + 1);
-    auto [term, _2] = floor_div(z_pow, denom);
+    floor_div_si(term, z_pow, 2 * i + 1);
     if (is_zero(term)) break;
-    sum = add_n(sum, term);
+    add_to(sum, sum, term);
   }
   mul_2exp(sum, 1);
   return mul_4exp(sum, -(log_guard));
@@ -528,15 +563,17 @@ constexpr z<C> log_rational(z<C> num, int k, int p) {
   } else {
     auto y_num = mul_4exp(nm, wp);
     auto [y_fp, _2] = floor_div(y_num, np);
-    auto y2 = fp_mul<C>(y_fp, y_fp, wp);
+    const prepared_multiplier<C> y2(fp_mul<C>(y_fp, y_fp, wp));
     auto sum = y_fp;
     auto y_pow = y_fp;
+    z<C> t, term;
     for (int i = 1;; ++i) {
-      y_pow = fp_mul<C>(y_pow, y2, wp);
+      fp_mul_into(t, y_pow, y2, wp);
+      std::swap(y_pow, t);
       if (is_zero(y_pow)) break;
-      auto [term, _3] = floor_div(y_pow, create<C>(2 * i + 1));
+      floor_div_si(term, y_pow, 2 * i + 1);
       if (is_zero(term)) break;
-      sum = add_n(sum, term);
+      add_to(sum, sum, term);
     }
     ln_rprime = sum;
     mul_2exp(ln_rprime, 1);
@@ -548,7 +585,8 @@ constexpr z<C> log_rational(z<C> num, int k, int p) {
 
   // ln(r) = 2m * ln(2) + ln(r')
   auto ln2_val = compute_ln2<C>(wp);
-  auto m_contrib = mul(create<C>(2 * m), ln2_val);
+  z<C> m_contrib;
+  mul_si(m_contrib, ln2_val, 2 * m);
   auto result = add(m_contrib, ln_rprime);
   return mul_4exp(result, -(log_guard));
 }
@@ -562,20 +600,21 @@ template <container C>
 constexpr z<C> atan_reciprocal(int n, int prec) {
   if (prec < 0) return zero<C>();
   const int wp = prec + atan_guard;
-  auto n2 = create<C>(static_cast<long long>(n) * n);
-  auto [power, _] = floor_div(mul_4exp(one<C>(), wp), create<C>(n));
+  const auto n2 = static_cast<long long>(n) * n;
+  auto power = mul_4exp(one<C>(), wp);
+  floor_div_si(power, power, n);
   if (is_zero(power)) return zero<C>();
   auto sum = power;
+  z<C> term;
   for (int i = 1;; ++i) {
-    auto [q, _2] = floor_div(power, n2);
-    power = std::move(q);
+    floor_div_si(power, power, n2);
     if (is_zero(power)) break;
-    auto [term, _3] = floor_div(power, create<C>(2 * i + 1));
+    floor_div_si(term, power, 2 * i + 1);
     if (is_zero(term)) break;
     if (i % 2 == 1)
-      sum = sub(sum, term);
+      sub_to(sum, sum, term);
     else
-      sum = add_n(sum, term);
+      add_to(sum, sum, term);
   }
   return mul_4exp(sum, -(atan_guard));
 }
@@ -589,7 +628,10 @@ constexpr z<C> compute_pi(int prec) {
   auto a = atan_reciprocal<C>(18, wp);
   auto b = atan_reciprocal<C>(57, wp);
   auto c = atan_reciprocal<C>(239, wp);
-  auto sum = sub(add(mul(create<C>(12), a), mul(create<C>(8), b)), mul(create<C>(5), c));
+  z<C> sum;
+  mul_si(sum, a, 12);
+  addmul_ui(sum, b, 8u);
+  submul_ui(sum, c, 5u);
   mul_4exp(sum, 1);  // multiply by 4: pi = 4 * (pi/4)
   return mul_4exp(sum, -(atan_guard));
 }
@@ -600,18 +642,20 @@ template <container C>
 constexpr z<C> atan_series(const z<C>& a, const z<C>& b, int prec) {
   auto [y_fp, _] = floor_div(mul_4exp(a, prec), b);
   if (is_zero(y_fp)) return zero<C>();
-  auto y2 = fp_mul<C>(y_fp, y_fp, prec);
+  const prepared_multiplier<C> y2(fp_mul<C>(y_fp, y_fp, prec));
   auto sum = y_fp;
   auto y_pow = y_fp;
+  z<C> t, term;
   for (int i = 1;; ++i) {
-    y_pow = fp_mul<C>(y_pow, y2, prec);
+    fp_mul_into(t, y_pow, y2, prec);
+    std::swap(y_pow, t);
     if (is_zero(y_pow)) break;
-    auto [term, _2] = floor_div(y_pow, create<C>(2 * i + 1));
+    floor_div_si(term, y_pow, 2 * i + 1);
     if (is_zero(term)) break;
     if (i % 2 == 1)
-      sum = sub(sum, term);
+      sub_to(sum, sum, term);
     else
-      sum = add_n(sum, term);
+      add_to(sum, sum, term);
   }
   return sum;
 }
@@ -641,24 +685,27 @@ constexpr z<C> atan_rational(z<C> num, int k, int p) {
     mul_2exp(two_denom, 1);
     if (cmp_n(two_denom, num) > 0) {
       // denom/num > 1/2: arctan(|y|) = pi/4 + arctan((num-denom)/(num+denom))
-      auto [pq, _] = floor_div(compute_pi<C>(wp), create<C>(4));
+      auto pq = compute_pi<C>(wp);
+      floor_div_si(pq, pq, 4);
       result = add(pq, atan_series<C>(sub(num, denom), add_n(num, denom), wp));
     } else {
       // denom/num <= 1/2: arctan(|y|) = pi/2 - arctan_series(denom, num)
-      auto [ph, _] = floor_div(compute_pi<C>(wp), create<C>(2));
+      auto ph = compute_pi<C>(wp);
+      floor_div_si(ph, ph, 2);
       result = sub(ph, atan_series<C>(denom, num, wp));
     }
   } else if (rel == 0) {
     // |y| = 1: arctan(1) = pi/4
-    auto [pq, _] = floor_div(compute_pi<C>(wp), create<C>(4));
-    result = pq;
+    result = compute_pi<C>(wp);
+    floor_div_si(result, result, 4);
   } else {
     // |y| < 1
     auto two_num = mul_4exp(num, 0);
     mul_2exp(two_num, 1);
     if (cmp_n(two_num, denom) > 0) {
       // |y| > 1/2: arctan(|y|) = pi/4 - arctan((denom-num)/(denom+num))
-      auto [pq, _] = floor_div(compute_pi<C>(wp), create<C>(4));
+      auto pq = compute_pi<C>(wp);
+      floor_div_si(pq, pq, 4);
       result = sub(pq, atan_series<C>(sub(denom, num), add_n(denom, num), wp));
     } else {
       // |y| <= 1/2: direct series
@@ -681,18 +728,18 @@ constexpr z<C> sin_series(const z<C>& num, int k, int prec) {
   const int wp = prec + sin_guard;
   auto [y_fp, _] = floor_div(mul_4exp(num, wp), mul_4exp(one<C>(), k));
   if (is_zero(y_fp)) return zero<C>();
-  auto y2 = fp_mul<C>(y_fp, y_fp, wp);
+  const prepared_multiplier<C> y2(fp_mul<C>(y_fp, y_fp, wp));
   auto sum = y_fp;
   auto term = y_fp;
+  z<C> t;
   for (int i = 1;; ++i) {
-    term = fp_mul<C>(term, y2, wp);
-    auto [q, _2] = floor_div(term, create<C>(static_cast<long long>(2 * i) * (2 * i + 1)));
-    term = q;
+    fp_mul_into(t, term, y2, wp);
+    floor_div_si(term, t, static_cast<long long>(2 * i) * (2 * i + 1));
     if (is_zero(term)) break;
     if (i % 2 == 1)
-      sum = sub(sum, term);
+      sub_to(sum, sum, term);
     else
-      sum = add_n(sum, term);
+      add_to(sum, sum, term);
   }
   return mul_4exp(sum, -sin_guard);
 }
@@ -710,7 +757,7 @@ constexpr r<C> exp(r<C> x) {
     // --- Test 1: very negative x -> exp(x) ~ 0 ---
     // m = 0 for B = 4 (since ceil(log_4(e/3)) = 0)
     auto x0 = co_await x.approx(0);
-    auto exp_x0_p = details::exp_rational<C>(x0, 0, p);
+    auto exp_x0_p = details::with_scratch_arena<C>([&] { return details::exp_rational<C>(x0, 0, p); });
     if (is_zero(exp_x0_p) || is_negative(exp_x0_p)) {
       co_return z<C>{};  // zero
     }
@@ -719,8 +766,8 @@ constexpr r<C> exp(r<C> x) {
     // Use signed comparison via sub (cmp_n is unsigned magnitude only)
     if (n > 0) {
       auto x_ell = co_await x.approx(ell);
-      auto log_lo = details::log_near_one_minus<C>(n, ell);
-      auto log_hi = details::log_near_one_plus<C>(n, ell);
+      auto log_lo = details::with_scratch_arena<C>([&] { return details::log_near_one_minus<C>(n, ell); });
+      auto log_hi = details::with_scratch_arena<C>([&] { return details::log_near_one_plus<C>(n, ell); });
       auto lo_bound = add(log_lo, create<C>(2));
       auto hi_bound = sub(log_hi, create<C>(2));
       auto diff_lo = sub(x_ell, lo_bound);
@@ -767,7 +814,7 @@ constexpr r<C> exp(r<C> x) {
     int k = details::compute_k(msd_x, p, d);
 
     auto x_k = co_await x.approx(k);
-    auto v = details::exp_rational<C>(x_k, k, p);
+    auto v = details::with_scratch_arena<C>([&] { return details::exp_rational<C>(x_k, k, p); });
     co_return mul_4exp(v, n - p);
   }};
 }
@@ -785,7 +832,7 @@ constexpr r<C> log(r<C> x) {
     auto xk = co_await x.approx(k);
 
     // v = floor(ln(xk / 4^k) * 4^(n+w))
-    auto v = details::log_rational<C>(xk, k, n + w);
+    auto v = details::with_scratch_arena<C>([&] { return details::log_rational<C>(xk, k, n + w); });
 
     // Result = floor((v + 1) / 4^w + 4^n / xk)
     //        = floor(((v + 1) * xk + 4^(n+w)) / (xk * 4^w))
@@ -813,7 +860,7 @@ constexpr r<C> arctan(r<C> x) {
     }
 
     // v = approximately arctan(xk / 4^k) * 4^(n+w) (within +/- 1)
-    auto v = details::atan_rational<C>(xk, k, n + w);
+    auto v = details::with_scratch_arena<C>([&] { return details::atan_rational<C>(xk, k, n + w); });
 
     // Result = floor((v + 1) / 4^w + 4^(n+k) / (4^(2n+2) + xk^2 + xk))
     // Use common-denominator integer arithmetic.
@@ -858,7 +905,7 @@ constexpr r<C> sin(r<C> x) {
     auto xk = co_await x.approx(k);
 
     // Compute pi_full = floor(pi * 4^k), pi_k = floor((pi/2) * 4^k)
-    auto pi_full = details::compute_pi<C>(k);
+    auto pi_full = details::with_scratch_arena<C>([&] { return details::compute_pi<C>(k); });
     if (is_zero(pi_full)) {
       co_return z<C>{};
     }
@@ -956,7 +1003,7 @@ constexpr r<C> sin(r<C> x) {
       // Case 2: sin positive — zk is between 0 and pi (= 2*pi_k)
       // Reduce to [0, pi/2]: if zk > pi_k, use sin(pi - arg) = sin(arg)
       z<C> arg = (cmp_n(zk, pi_k) > 0) ? sub(two_pi_k, zk) : zk;
-      auto v = details::sin_series<C>(arg, k, n + w);
+      auto v = details::with_scratch_arena<C>([&] { return details::sin_series<C>(arg, k, n + w); });
       auto v_plus_1 = add(v, details::one<C>());
       auto [q, _s4] = floor_div(v_plus_1, mul_4exp(details::one<C>(), w));
       result = add(q, mul_4exp(details::one<C>(), n - k));
@@ -966,7 +1013,7 @@ constexpr r<C> sin(r<C> x) {
       z<C> shifted = sub(zk, two_pi_k);
       // Now shifted is in (0, 2*pi_k), compute sin of it
       z<C> arg = (cmp_n(shifted, pi_k) > 0) ? sub(two_pi_k, shifted) : shifted;
-      auto v = details::sin_series<C>(arg, k, n + w);
+      auto v = details::with_scratch_arena<C>([&] { return details::sin_series<C>(arg, k, n + w); });
       auto v_minus_1 = sub(v, details::one<C>());
       auto [q, _s5] = floor_div(v_minus_1, mul_4exp(details::one<C>(), w));
       result = sub(q, mul_4exp(details::one<C>(), n - k));
@@ -1089,4 +1136,36 @@ constexpr r<C> log_base(r<C> x, r<C> b) {
 
 }  // namespace epx
 
+#if defined(EPSILON_EXTERN_TEMPLATE)
+namespace epx {
+
+EPSILON_EXTERN_TEMPLATE class r<default_container_type>;
+EPSILON_EXTERN_TEMPLATE r<default_container_type> make_q(z<>, z<>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> add(r<default_container_type>, r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> opp(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE coro::lazy<int> msd(r<default_container_type>, int);
+EPSILON_EXTERN_TEMPLATE coro::lazy<int> msd(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> mul(r<default_container_type>, r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> inv(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> root(r<default_container_type>, int);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> exp(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> log(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arctan(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> sin(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> cos(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> tan(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arcsin(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arccos(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> sinh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> cosh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> tanh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arcsinh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arccosh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> arctanh(r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> pow(r<default_container_type>, r<default_container_type>);
+EPSILON_EXTERN_TEMPLATE r<default_container_type> log_base(r<default_container_type>, r<default_container_type>);
+
+}  // namespace epx
+#endif
+
 #endif  // EPSILON_INC_R_HPP
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#ifndef EPSILON_INC_SCRATCH_HPP
+#define EPSILON_INC_SCRATCH_HPP
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+
+// epx
+#include "t.hpp"
+
+namespace epx {
+
+namespace details {
+
+// Stack of scratch memory for the span kernels in z.hpp, one per thread. Blocks are taken from the
+// top and returned in reverse order, so a kernel and every level of its recursion pay a pointer bump
+// instead of a heap allocation. A block that does not fit on the stack comes from the heap; once the
+// stack is empty again, it is regrown to the peak usage seen so far, so that repeating a computation
+// runs from the stack alone.
+//
+// Memory ceiling: the stack is never regrown beyond max(scratch_limit, reserved) bytes, the largest
+// reserve() request of the thread. That is the most a thread keeps between calls; it is freed by
+// release() or when the thread exits. Peaks above it keep spilling to the heap.
+class scratch_stack {
+ public:
+  static constexpr size_t alignment = alignof(std::max_align_t);
+
+  scratch_stack() = default;
+  scratch_stack(const scratch_stack&) = delete;
+  scratch_stack& operator=(const scratch_stack&) = delete;
+  ~scratch_stack() { ::operator delete(base_); }
+
+  // The stack of the calling thread.
+  static scratch_stack& local() noexcept {
+    thread_local scratch_stack stack;
+    return stack;
+  }
+
+  // Bytes that a block of the given size takes on the stack.
+  static constexpr size_t block_size(size_t bytes) noexcept { return (bytes + alignment - 1) / alignment * alignment; }
+
+  void* allocate(size_t bytes) {
+    if (bytes == 0) return nullptr;
+    bytes = block_size(bytes);
+    in_use_ += bytes;
+    peak_ = std::max(peak_, in_use_);
+    if (bytes <= size_ - top_) {
+      void* p = base_ + top_;
+      top_ += bytes;
+      return p;
+    }
+    return ::operator new(bytes);
+  }
+
+  void deallocate(void* p, size_t bytes) noexcept {
+    if (bytes == 0) return;
+    bytes = block_size(bytes);
+    in_use_ -= bytes;
+    auto* b = static_cast<std::byte*>(p);
+    if (!std::less<>{}(b, base_) && std::less<>{}(b, base_ + size_)) {
+      assert(b + bytes == base_ + top_);  // blocks are returned in reverse order
+      top_ -= bytes;
+    } else {
+      ::operator delete(p);
+    }
+    if (in_use_ == 0 && peak_ > size_) {
+      const auto cap = std::max(scratch_limit<global_config_tag>, reserved_);
+      if (size_ < cap) regrow(block_size(std::min(peak_, cap)));
+    }
+  }
+
+  // Makes room for bytes of scratch, at once if the stack is not in use, or else when it next is
+  // empty. May take the stack beyond scratch_limit.
+  void reserve(size_t bytes) {
+    bytes = block_size(bytes);
+    reserved_ = std::max(reserved_, bytes);
+    peak_ = std::max(peak_, bytes);
+    if (in_use_ == 0 && bytes > size_) regrow(bytes);
+  }
+
+  // Frees the stack, which must not be in use, and forgets its peak and reservations.
+  void release() noexcept {
+    assert(in_use_ == 0);
+    ::operator delete(std::exchange(base_, nullptr));
+    size_ = top_ = peak_ = reserved_ = 0;
+  }
+
+  // Bytes held by the stack.
+  size_t capacity() const noexcept { return size_; }
+  // Bytes taken by live blocks, including those spilled to the heap.
+  size_t in_use() const noexcept { return in_use_; }
+
+ private:
+  void regrow(size_t bytes) {
+    assert(top_ == 0);
+    ::operator delete(std::exchange(base_, nullptr));
+    size_ = 0;
+    base_ = static_cast<std::byte*>(::operator new(bytes));
+    size_ = bytes;
+  }
+
+  std::byte* base_ = nullptr;
+  size_t size_ = 0;
+  size_t top_ = 0;
+  size_t in_use_ = 0;
+  size_t peak_ = 0;
+  size_t reserved_ = 0;
+};
+
+// n digits of scratch from the stack of the calling thread, returned when the buffer is destroyed;
+// buffers are therefore destroyed in reverse order of construction, as locals are. The digits are
+// left uninitialized. During constant evaluation they come from std::allocator instead.
+template <class D>
+class scratch_buffer {
+ public:
+  constexpr explicit scratch_buffer(size_t n) : n_(n) {
+    if consteval {
+      p_ = std::allocator<D>{}.allocate(n);
+      for (size_t i = 0; i < n; ++i) std::construct_at(p_ + i);
+    } else {
+      p_ = static_cast<D*>(scratch_stack::local().allocate(n * sizeof(D)));
+    }
+  }
+  scratch_buffer(const scratch_buffer&) = delete;
+  scratch_buffer& operator=(const scratch_buffer&) = delete;
+  constexpr ~scratch_buffer() {
+    if consteval {
+      std::allocator<D>{}.deallocate(p_, n_);
+    } else {
+      scratch_stack::local().deallocate(p_, n_ * sizeof(D));
+    }
+  }
+
+  constexpr std::span<D> span() const noexcept { return {p_, n_}; }
+  constexpr operator std::span<D>() const noexcept { return span(); }
+  constexpr operator std::span<const D>() const noexcept { return span(); }
+
+ private:
+  D* p_ = nullptr;
+  size_t n_;
+};
+
+}  // namespace details
+
+}  // namespace epx
+
+#endif  // EPSILON_INC_SCRATCH_HPP
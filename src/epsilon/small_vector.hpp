@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+#ifndef EPSILON_INC_SMALL_VECTOR_HPP
+#define EPSILON_INC_SMALL_VECTOR_HPP
+
+// std
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace epx {
+
+// Digit container with inline storage for N digits, spilling to the heap beyond that. Most values in
+// r.hpp (small constants, series denominators, msd probes) have a few digits, so z<small_vector<D>>
+// avoids a heap allocation for each of them. Satisfies the container concept and is contiguous, so
+// the span kernels in z.hpp apply to it directly.
+template <class T, size_t N = 32 / sizeof(T)>
+  requires std::is_trivially_copyable_v<T> && (N > 0)
+class small_vector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  static constexpr size_type inline_capacity = N;
+
+  constexpr small_vector() = default;
+  constexpr explicit small_vector(size_type n) { resize(n); }
+  constexpr small_vector(size_type n, const T& val) { resize(n, val); }
+  constexpr small_vector(std::initializer_list<T> il) : small_vector(il.begin(), il.end()) {}
+  template <std::input_iterator It>
+  constexpr small_vector(It first, It last) {
+    if constexpr (std::forward_iterator<It>) {
+      reserve(static_cast<size_type>(std::distance(first, last)));
+    }
+    for (; first != last; ++first) push_back(*first);
+  }
+
+  constexpr small_vector(const small_vector& other) : small_vector(other.begin(), other.end()) {}
+  constexpr small_vector(small_vector&& other) noexcept { steal(other); }
+
+  constexpr small_vector& operator=(const small_vector& other) {
+    if (this != &other) {
+      size_ = 0;
+      reserve(other.size_);
+      std::copy(other.begin(), other.end(), data());
+      size_ = other.size_;
+    }
+    return *this;
+  }
+
+  constexpr small_vector& operator=(small_vector&& other) noexcept {
+    if (this != &other) {
+      release();
+      steal(other);
+    }
+    return *this;
+  }
+
+  constexpr ~small_vector() { release(); }
+
+  constexpr pointer data() noexcept { return heap_ ? heap_ : buf_; }
+  constexpr const_pointer data() const noexcept { return heap_ ? heap_ : buf_; }
+  constexpr size_type size() const noexcept { return size_; }
+  constexpr size_type capacity() const noexcept { return heap_ ? cap_ : N; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  // True while the digits live in the inline buffer.
+  constexpr bool is_inline() const noexcept { return heap_ == nullptr; }
+
+  constexpr iterator begin() noexcept { return data(); }
+  constexpr const_iterator begin() const noexcept { return data(); }
+  constexpr const_iterator cbegin() const noexcept { return data(); }
+  constexpr iterator end() noexcept { return data() + size_; }
+  constexpr const_iterator end() const noexcept { return data() + size_; }
+  constexpr const_iterator cend() const noexcept { return data() + size_; }
+  constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  constexpr reference operator[](size_type i) { return data()[i]; }
+  constexpr const_reference operator[](size_type i) const { return data()[i]; }
+  constexpr reference front() { return data()[0]; }
+  constexpr const_reference front() const { return data()[0]; }
+  constexpr reference back() { return data()[size_ - 1]; }
+  constexpr const_reference back() const { return data()[size_ - 1]; }
+
+  constexpr void reserve(size_type n) {
+    if (n > capacity()) grow(n);
+  }
+
+  constexpr void resize(size_type n) { resize(n, T{}); }
+  constexpr void resize(size_type n, const T& val) {
+    if (n > size_) {
+      const T v = val;  // val may refer to an element
+      reserve(n);
+      std::fill(data() + size_, data() + n, v);
+    }
+    size_ = n;
+  }
+
+  constexpr void clear() noexcept { size_ = 0; }
+
+  constexpr void push_back(const T& val) {
+    if (size_ == capacity()) {
+      const T v = val;
+      grow(size_ + 1);
+      data()[size_++] = v;
+    } else {
+      data()[size_++] = val;
+    }
+  }
+
+  constexpr void pop_back() { --size_; }
+
+  constexpr iterator insert(const_iterator pos, size_type count, const T& val) {
+    const auto off = static_cast<size_type>(pos - begin());
+    const T v = val;
+    reserve(size_ + count);
+    T* p = data();
+    std::copy_backward(p + off, p + size_, p + size_ + count);
+    std::fill(p + off, p + off + count, v);
+    size_ += count;
+    return p + off;
+  }
+
+  constexpr iterator insert(const_iterator pos, const T& val) { return insert(pos, 1, val); }
+
+  constexpr iterator erase(const_iterator first, const_iterator last) {
+    T* p = data();
+    const auto off = static_cast<size_type>(first - p);
+    const auto count = static_cast<size_type>(last - first);
+    std::copy(p + off + count, p + size_, p + off);
+    size_ -= count;
+    return p + off;
+  }
+
+  constexpr iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  constexpr void swap(small_vector& other) noexcept {
+    small_vector tmp = std::move(other);
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  friend constexpr bool operator==(const small_vector& lhs, const small_vector& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend constexpr auto operator<=>(const small_vector& lhs, const small_vector& rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+ private:
+  // Moves the digits to a heap block of at least n elements, growing geometrically.
+  constexpr void grow(size_type n) {
+    const size_type cap = std::max(n, 2 * capacity());
+    std::allocator<T> alloc;
+    T* p = alloc.allocate(cap);
+    if consteval {
+      for (size_type i = 0; i < cap; ++i) std::construct_at(p + i);
+    }
+    std::copy(begin(), end(), p);
+    release();
+    heap_ = p;
+    cap_ = cap;
+  }
+
+  constexpr void release() noexcept {
+    if (heap_) {
+      std::allocator<T>{}.deallocate(heap_, cap_);
+      heap_ = nullptr;
+      cap_ = 0;
+    }
+  }
+
+  // Takes the heap block of other, or copies its inline digits; leaves other empty.
+  constexpr void steal(small_vector& other) noexcept {
+    if (other.heap_) {
+      heap_ = std::exchange(other.heap_, nullptr);
+      cap_ = std::exchange(other.cap_, 0);
+    } else {
+      std::copy(other.buf_, other.buf_ + other.size_, buf_);
+    }
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  T* heap_ = nullptr;
+  size_type size_ = 0;
+  size_type cap_ = 0;
+  T buf_[N]{};
+};
+
+template <class T, size_t N>
+constexpr void swap(small_vector<T, N>& lhs, small_vector<T, N>& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+}  // namespace epx
+
+#endif  // EPSILON_INC_SMALL_VECTOR_HPP
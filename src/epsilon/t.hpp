@@ -3,22 +3,38 @@
 
 // std
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <ranges>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 namespace epx {
 
-using default_digit_type = uint32_t;
-using max_digit_type = uint32_t;
+// Double-width products and divisions of 64-bit digits use the native 128-bit type where there is
+// one (GCC and Clang). Elsewhere, e.g. MSVC, wide_digit_type has no 64-bit entry, and umul and
+// div_2d compute them from intrinsics or half digits instead.
+#if defined(__SIZEOF_INT128__)
+#define EPSILON_HAS_INT128 1
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+using default_digit_type = uint64_t;
+using max_digit_type = uint64_t;
 using default_container_type = std::vector<default_digit_type>;
 
 struct bad_digit_type;
 template <class D>
-using wide_digit_type =
-    std::conditional_t<sizeof(D) == sizeof(uint8_t), uint16_t,
-                       std::conditional_t<sizeof(D) == sizeof(uint16_t), uint32_t,
-                                          std::conditional_t<sizeof(D) == sizeof(uint32_t), uint64_t, bad_digit_type>>>;
+using wide_digit_type = std::conditional_t<
+    sizeof(D) == sizeof(uint8_t), uint16_t,
+    std::conditional_t<sizeof(D) == sizeof(uint16_t), uint32_t,
+                       std::conditional_t<sizeof(D) == sizeof(uint32_t), uint64_t,
+#if defined(EPSILON_HAS_INT128)
+                                          std::conditional_t<sizeof(D) == sizeof(uint64_t), uint128_t, bad_digit_type>
+#else
+                                          bad_digit_type
+#endif
+                                          >>>;
 
 template <class T>
 concept container = std::ranges::random_access_range<T> &&  //
@@ -30,7 +46,7 @@ concept container = std::ranges::random_access_range<T> &&  //
                       c.push_back(typename T::value_type{});
                       c.reserve(size_t{});
                       sizeof(typename T::value_type) < sizeof(max_digit_type);
-                    };
+                    } && sizeof(typename T::value_type) <= sizeof(max_digit_type);
 
 enum class sign : uint8_t { positive, negative };
 
@@ -49,6 +65,50 @@ struct global_config_tag {};  // allow user-defined configs
 template <typename>
 constexpr int max_msd = 10000;  // can be overridden by global_config_tag
 
+// Multiplication crossover, in digits of the shorter operand. Below it mul_n uses the schoolbook
+// product. Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t karatsuba_threshold = 32;
+
+// Crossovers to the Toom-3 and Toom-4 multiplication tiers, in digits of the shorter operand.
+// Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t toom3_threshold = 128;
+template <typename>
+constexpr size_t toom4_threshold = 384;
+
+// Crossover to the number-theoretic transform multiplication, in digits of the shorter operand.
+// The default is tuned for default_digit_type. Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t ntt_threshold = 1024 * sizeof(default_digit_type) / sizeof(uint32_t);
+
+// Base case size of the Burnikel-Ziegler recursive division, in digits of the divisor. div_n uses
+// it once both the divisor and the quotient have at least twice as many digits. Can be overridden
+// by global_config_tag.
+template <typename>
+constexpr size_t bz_threshold = 128;
+
+// Crossover to division by a Newton reciprocal, in digits of the divisor and of the quotient.
+// The default is tuned for default_digit_type. Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t newton_threshold = size_t{1} << 18;
+
+// Divisor size, in digits, from which divisor precomputes a Barrett reciprocal and divides by two
+// multiplications per divisor-sized block. The default is tuned for default_digit_type. Can be
+// overridden by global_config_tag.
+template <typename>
+constexpr size_t barrett_threshold = 8192 * sizeof(default_digit_type) / sizeof(uint32_t);
+
+// Size, in digits, from which gcd reduces pairs by half-GCD recursion instead of Lehmer steps.
+// Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t hgcd_threshold = 128;
+
+// Most scratch memory, in bytes, that a thread keeps for the multiplication and division kernels
+// between calls; see details::scratch_stack. Can be overridden by global_config_tag.
+template <typename>
+constexpr size_t scratch_limit = size_t{1} << 24;
+
 struct divide_by_zero_error : public std::runtime_error {
   divide_by_zero_error() : std::runtime_error("epx: divide by zero") {}
 };
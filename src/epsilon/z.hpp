@@ -6,17 +6,39 @@
 
 // std
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <cassert>
+#include <climits>
 #include <concepts>
 #include <limits>
 #include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define EPSILON_HAS_ADDCARRY 1
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 // epx
+#include "core.hpp"
+#include "ntt.hpp"
+#include "scratch.hpp"
 #include "t.hpp"
 
 namespace epx {
 
+template <container C, std::integral T>
+constexpr z<C> create(T val);
+
+template <container C, std::unsigned_integral U>
+constexpr z<C> pow_ui(U base, unsigned exp);
+
 namespace details {
 
 template <container C>
@@ -35,55 +57,217 @@ constexpr z<C> base() {
 }
 
 template <container C>
-constexpr z<C> ten() {
-  return z<C>{.digits = {10}};
+constexpr z<C> pow10(unsigned exp) {
+  return pow_ui<C>(10u, exp);
 }
 
-template <container C>
-constexpr z<C> pow10(unsigned exp) {
-  auto res = one<C>();
-  for (unsigned i = 0; i < exp; ++i) {
-    res = mul_n(res, ten<C>());
-  }
-  return res;
+// lhs * rhs = p1 * B + p0 from four half-digit products. The portable path behind umul.
+template <std::unsigned_integral T>
+constexpr auto umul_generic(T lhs, T rhs) {
+  struct result_t {
+    T p0;
+    T p1;
+  };
+
+  constexpr T s = sizeof(T) * 4u;
+  constexpr T mask = std::numeric_limits<T>::max() >> s;
+  T a0 = lhs & mask, b0 = rhs & mask;
+  T a1 = lhs >> s, b1 = rhs >> s;
+  T ll = a0 * b0, lh = a0 * b1, hl = a1 * b0, hh = a1 * b1;
+  T w = lh + (ll >> s);
+  w += hl;
+  if (w < hl) hh += mask + 1u;
+  return result_t{.p0 = (w << s) + (ll & mask), .p1 = hh + (w >> s)};
 }
 
-template <class MaxD, std::unsigned_integral T>
+// Full product of two digits, lhs * rhs = p1 * B + p0. Uses the native double-width type when
+// there is one, _umul128 for 64-bit digits on MSVC, and umul_generic otherwise.
+template <std::unsigned_integral T>
 constexpr auto umul(T lhs, T rhs) {
   struct result_t {
     T p0;
     T p1;
   };
 
-  if constexpr (sizeof(T) >= sizeof(MaxD)) {
-    constexpr T s = sizeof(T) * 4u;
-    constexpr T mask = std::numeric_limits<T>::max() >> s;
-    T a0 = lhs & mask, b0 = rhs & mask;
-    T a1 = lhs >> s, b1 = rhs >> s;
-    T ll = a0 * b0, lh = a0 * b1, hl = a1 * b0, hh = a1 * b1;
-    T w = lh + (ll >> s);
-    w += hl;
-    if (w < hl) hh += mask + 1u;
-    return result_t{.p0 = (w << s) + (ll & mask), .p1 = hh + (w >> s)};
-  } else {
+  using W = wide_digit_type<T>;
+  if constexpr (!std::is_same_v<W, bad_digit_type>) {
     constexpr unsigned s = sizeof(T) * 8u;
-    MaxD l = lhs, r = rhs;
-    auto prod = l * r;
+    W prod = static_cast<W>(lhs) * rhs;
     return result_t{.p0 = static_cast<T>(prod), .p1 = static_cast<T>(prod >> s)};
+  } else {
+#if defined(_MSC_VER) && defined(_M_X64)
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+      if !consteval {
+        unsigned long long p1;
+        const unsigned long long p0 = _umul128(lhs, rhs, &p1);
+        return result_t{.p0 = static_cast<T>(p0), .p1 = static_cast<T>(p1)};
+      }
+    }
+#endif
+    auto [p0, p1] = umul_generic(lhs, rhs);
+    return result_t{.p0 = p0, .p1 = p1};
   }
 }
 
-// u0 - LSD, u1 - MSD
-template <class D>
+// (u1 * B + u0) / v for u1 < v in base B^(1/2): Knuth's Algorithm D with two half-digit quotient
+// digits (Warren, "Hacker's Delight", divlu). The portable path behind div_2d.
+template <std::unsigned_integral D>
+constexpr auto div_2d_generic(D u0, D u1, D v) {
+  struct result_t {
+    D q;
+    D r;
+  };
+
+  constexpr int h = static_cast<int>(sizeof(D) * 4u);
+  constexpr D b = D{1} << h;
+  constexpr D mask = b - 1u;
+  assert(u1 < v);
+  const int s = std::countl_zero(v);
+  v = static_cast<D>(v << s);
+  const D vn1 = v >> h, vn0 = v & mask;
+  const D un32 = s == 0 ? u1 : static_cast<D>((u1 << s) | (u0 >> (2 * h - s)));
+  const D un10 = static_cast<D>(u0 << s);
+  const D un1 = un10 >> h, un0 = un10 & mask;
+
+  D q1 = un32 / vn1;
+  D rhat = static_cast<D>(un32 - q1 * vn1);
+  while (q1 >= b || static_cast<D>(q1 * vn0) > static_cast<D>((rhat << h) | un1)) {
+    --q1;
+    rhat += vn1;
+    if (rhat >= b) break;
+  }
+  const auto un21 = static_cast<D>((un32 << h) + un1 - q1 * v);  // below v, so the wrap is exact
+
+  D q0 = un21 / vn1;
+  rhat = static_cast<D>(un21 - q0 * vn1);
+  while (q0 >= b || static_cast<D>(q0 * vn0) > static_cast<D>((rhat << h) | un0)) {
+    --q0;
+    rhat += vn1;
+    if (rhat >= b) break;
+  }
+  const auto r = static_cast<D>((un21 << h) + un0 - q0 * v);
+  return result_t{.q = static_cast<D>((q1 << h) | q0), .r = static_cast<D>(r >> s)};
+}
+
+// (u1 * B + u0) / v for u1 < v, so that the quotient fits in a digit. u0 - LSD, u1 - MSD. Uses the
+// native double-width type when there is one, _udiv128 for 64-bit digits on MSVC, and
+// div_2d_generic otherwise.
+template <std::unsigned_integral D>
 constexpr auto div_2d(D u0, D u1, D v) {
+  struct result_t {
+    D q;
+    D r;
+  };
+
+  assert(u1 < v);
   using W = wide_digit_type<D>;
+  if constexpr (!std::is_same_v<W, bad_digit_type>) {
+    W u = (static_cast<W>(u1) << (sizeof(D) * CHAR_BIT)) | u0;
+    return result_t{.q = static_cast<D>(u / v), .r = static_cast<D>(u % v)};
+  } else {
+#if defined(_MSC_VER) && defined(_M_X64)
+    if constexpr (sizeof(D) == sizeof(uint64_t)) {
+      if !consteval {
+        unsigned long long r;
+        const unsigned long long q = _udiv128(u1, u0, v, &r);
+        return result_t{.q = static_cast<D>(q), .r = static_cast<D>(r)};
+      }
+    }
+#endif
+    auto [q, r] = div_2d_generic(u0, u1, v);
+    return result_t{.q = q, .r = r};
+  }
+}
+
+// Reciprocal of a normalized digit d (top bit set): floor((B^2 - 1) / d) - B, which is the
+// one-digit quotient of ((B - 1 - d) * B + B - 1) / d.
+template <class D>
+constexpr D reciprocal_1(D d) {
+  assert(d >> (sizeof(D) * CHAR_BIT - 1) == 1);
+  return div_2d(static_cast<D>(~D{0}), static_cast<D>(~d), d).q;
+}
+
+// (u1 * B + u0) / d for a normalized digit d > u1, given v = reciprocal_1(d). Uses multiplications
+// only (Moller and Granlund, "Improved division by invariant integers", Algorithm 4).
+template <class D>
+constexpr auto div_2by1(D u1, D u0, D d, D v) {
   struct result_t {
-    W q;
+    D q;
     D r;
   };
-  assert(v != 0);
-  W u = (static_cast<W>(u1) << (sizeof(D) * CHAR_BIT)) | u0;
-  return result_t{.q = static_cast<W>(u / v), .r = static_cast<D>(u % v)};
+  assert(u1 < d);
+  auto [q0, q1] = umul(v, u1);
+  q0 = static_cast<D>(q0 + u0);
+  q1 = static_cast<D>(q1 + u1 + 1u + (q0 < u0 ? 1u : 0u));
+  auto r = static_cast<D>(u0 - q1 * d);
+  if (r > q0) {
+    --q1;
+    r = static_cast<D>(r + d);
+  }
+  if (r >= d) [[unlikely]] {
+    ++q1;
+    r = static_cast<D>(r - d);
+  }
+  return result_t{.q = q1, .r = r};
+}
+
+// q = |u| / d for a digit d with d << s normalized to dn and v = reciprocal_1(dn); returns |u| mod d.
+// Each digit costs multiplications instead of a hardware division. q may be u; the sign of q is
+// left as it was and its digits are not normalized.
+template <container C>
+constexpr typename z<C>::digit_type div_1_norm(z<C>& q, const z<C>& u, typename z<C>::digit_type dn,
+                                               typename z<C>::digit_type v, int s) {
+  using D = typename z<C>::digit_type;
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  const auto n = std::ranges::size(u.digits);
+  if (&q != &u) q.digits.resize(n);
+  if (n == 0) return D{0};
+
+  if (s == 0) {
+    D r = 0;
+    for (auto i = n; i > 0; --i) {
+      auto [qd, rd] = div_2by1(r, u.digits[i - 1], dn, v);
+      q.digits[i - 1] = qd;
+      r = rd;
+    }
+    return r;
+  }
+  // divide u * 2^s by d * 2^s, shifting the digits of u on the fly
+  D hi = u.digits[n - 1];
+  auto r = static_cast<D>(hi >> (dbits - s));
+  for (auto i = n; i > 0; --i) {
+    const D lo = i > 1 ? u.digits[i - 2] : D{0};
+    auto [qd, rd] = div_2by1(r, static_cast<D>((hi << s) | (lo >> (dbits - s))), dn, v);
+    q.digits[i - 1] = qd;
+    r = rd;
+    hi = lo;
+  }
+  return static_cast<D>(r >> s);
+}
+
+// q = |u| / d for a digit d != 0; returns |u| mod d. 32- and 64-bit digits go through div_1_norm,
+// with the reciprocal replacing a hardware division (a library call for 128/64 bits) per digit.
+// Narrower digits divide natively, which is faster. q may be u; the sign of q is left as it was and
+// its digits are not normalized.
+template <container C>
+constexpr typename z<C>::digit_type div_1(z<C>& q, const z<C>& u, typename z<C>::digit_type d) {
+  using D = typename z<C>::digit_type;
+  assert(d != 0);
+  if constexpr (sizeof(D) < sizeof(uint32_t)) {
+    const auto n = std::ranges::size(u.digits);
+    if (&q != &u) q.digits.resize(n);
+    D r = 0;
+    for (auto i = n; i > 0; --i) {
+      auto [qd, rd] = div_2d(u.digits[i - 1], r, d);
+      q.digits[i - 1] = qd;
+      r = rd;
+    }
+    return r;
+  } else {
+    const int s = std::countl_zero(d);
+    const auto dn = static_cast<D>(d << s);
+    return div_1_norm(q, u, dn, reciprocal_1(dn), s);
+  }
 }
 
 template <container C>
@@ -92,7 +276,7 @@ constexpr auto bit_shift(C& digits, int offset) {
   assert((sizeof(D) * CHAR_BIT) > (size_t)std::abs(offset));
   if (offset > 0) {
     // left shift
-    const D mask = ((1u << offset) - 1) << (sizeof(D) * CHAR_BIT - offset);
+    const D mask = ((D{1} << offset) - 1) << (sizeof(D) * CHAR_BIT - offset);
     D cy = 0;
     for (auto& d : digits) {
       D t = (d << offset) | cy;
@@ -103,7 +287,7 @@ constexpr auto bit_shift(C& digits, int offset) {
   } else if (offset < 0) {
     offset = std::abs(offset);
     // right shift
-    const D mask = (1u << offset) - 1;
+    const D mask = (D{1} << offset) - 1;
     D cy = 0;
     for (auto d = digits.rbegin(); d != digits.rend(); ++d) {
       D t = (*d >> offset) | cy;
@@ -124,435 +308,2440 @@ constexpr int bit_length(const C& digits) noexcept {
   D msd = digits[dcount - 1];
   return static_cast<int>(dcount * sizeof(D) * CHAR_BIT) - std::countl_zero(msd);
 };
-}  // namespace details
 
-template <container C, std::integral T>
-constexpr z<C> create(T val) {
-  z<C> res;
-  if (val == 0) {
-    return res;
-  }
-  if constexpr (std::is_signed_v<T>) {
-    res.sgn = val < 0 ? sign::negative : sign::positive;
-    val = val < 0 ? -val : val;
-  }
-  using D = typename z<C>::digit_type;
-  if constexpr (sizeof(T) <= sizeof(D)) {
-    res.digits.push_back(static_cast<D>(val));
+// The limb kernels below work on raw digit spans (LSD first) and never allocate. Unless noted
+// otherwise, the destination may alias a source operand only if both start at the same digit.
+
+#if defined(EPSILON_HAS_ADDCARRY)
+// Hardware carry-chain steps: r = a + b + c (resp. a - b - c), returning the carry (resp. borrow).
+template <class D>
+inline unsigned char addcarry(unsigned char c, D a, D b, D* r) {
+  if constexpr (sizeof(D) == sizeof(uint64_t)) {
+    unsigned long long t;
+    c = _addcarry_u64(c, a, b, &t);
+    *r = static_cast<D>(t);
   } else {
-    while (val > 0) {
-      res.digits.push_back(static_cast<D>(val));
-      val >>= (sizeof(D) * CHAR_BIT);
-    }
+    static_assert(sizeof(D) == sizeof(uint32_t));
+    unsigned int t;
+    c = _addcarry_u32(c, a, b, &t);
+    *r = static_cast<D>(t);
   }
-  return res;
-}
-
-template <container C>
-constexpr bool is_zero(const z<C>& num) noexcept {
-  return std::ranges::size(num.digits) == 0;
+  return c;
 }
 
-template <container C>
-constexpr bool is_negative(const z<C>& num) noexcept {
-  return num.sgn == sign::negative;
+template <class D>
+inline unsigned char subborrow(unsigned char c, D a, D b, D* r) {
+  if constexpr (sizeof(D) == sizeof(uint64_t)) {
+    unsigned long long t;
+    c = _subborrow_u64(c, a, b, &t);
+    *r = static_cast<D>(t);
+  } else {
+    static_assert(sizeof(D) == sizeof(uint32_t));
+    unsigned int t;
+    c = _subborrow_u32(c, a, b, &t);
+    *r = static_cast<D>(t);
+  }
+  return c;
 }
 
-template <container C>
-constexpr z<C>& normalize(z<C>& num) noexcept {
-  using D = typename z<C>::digit_type;
-  auto pos = std::find_if(num.digits.rbegin(), num.digits.rend(), [](D x) { return x != 0; });
-  num.digits.resize(std::ranges::size(num.digits) - std::ranges::distance(num.digits.rbegin(), pos));
-  num.sgn = num.digits.empty() == false ? num.sgn : sign::positive;
-  return num;
+// Carry-chain kernels behind add_limbs and sub_limbs, unrolled by four. Once the carry out of the
+// common part dies, the rest of a is copied instead of propagated.
+template <class D>
+inline D add_limbs_adc(D* r, const D* a, const D* b, size_t an, size_t bn) {
+  unsigned char c = 0;
+  size_t i = 0;
+  for (; i + 4 <= bn; i += 4) {
+    c = addcarry(c, a[i], b[i], &r[i]);
+    c = addcarry(c, a[i + 1], b[i + 1], &r[i + 1]);
+    c = addcarry(c, a[i + 2], b[i + 2], &r[i + 2]);
+    c = addcarry(c, a[i + 3], b[i + 3], &r[i + 3]);
+  }
+  for (; i < bn; ++i) c = addcarry(c, a[i], b[i], &r[i]);
+  for (; i < an && c; ++i) c = addcarry(c, a[i], D{0}, &r[i]);
+  if (r != a) std::copy(a + i, a + an, r + i);
+  return c;
 }
 
-template <container C>
-constexpr z<C>& negate(z<C>& num) noexcept {
-  if (is_zero(num)) {
-    return num;
+template <class D>
+inline D sub_limbs_sbb(D* r, const D* a, const D* b, size_t an, size_t bn) {
+  unsigned char c = 0;
+  size_t i = 0;
+  for (; i + 4 <= bn; i += 4) {
+    c = subborrow(c, a[i], b[i], &r[i]);
+    c = subborrow(c, a[i + 1], b[i + 1], &r[i + 1]);
+    c = subborrow(c, a[i + 2], b[i + 2], &r[i + 2]);
+    c = subborrow(c, a[i + 3], b[i + 3], &r[i + 3]);
   }
-  num.sgn = is_negative(num) ? sign::positive : sign::negative;
-  return num;
+  for (; i < bn; ++i) c = subborrow(c, a[i], b[i], &r[i]);
+  for (; i < an && c; ++i) c = subborrow(c, a[i], D{0}, &r[i]);
+  if (r != a) std::copy(a + i, a + an, r + i);
+  return c;
 }
 
-template <container C>
-constexpr int cmp_n(const z<C>& lhs, const z<C>& rhs) {
-  if (std::ranges::size(lhs.digits) != std::ranges::size(rhs.digits)) {
-    return std::ranges::size(lhs.digits) < std::ranges::size(rhs.digits) ? -1 : 1;
+// Kernel behind addmul_1_limbs_generic. Both carries of a digit go into the high half of its
+// product (adc), which cannot overflow, rather than through compares.
+template <class D>
+inline D addmul_1_adc(D* r, const D* a, size_t n, D v) {
+  D cy = 0;
+  for (size_t i = 0; i < n; ++i) {
+    auto [p0, p1] = umul(a[i], v);
+    p1 += addcarry(0, p0, cy, &p0);
+    cy = p1 + addcarry(0, r[i], p0, &r[i]);
   }
-
-  auto res = std::lexicographical_compare_three_way(std::ranges::crbegin(lhs.digits), std::ranges::crend(lhs.digits),
-                                                    std::ranges::crbegin(rhs.digits), std::ranges::crend(rhs.digits));
-  if (res < 0) return -1;
-  if (res > 0) return 1;
-  return 0;
+  return cy;
 }
+#endif
 
-template <container C>
-constexpr z<C> add_n(const z<C>& lhs, const z<C>& rhs) {
-  using D = typename z<C>::digit_type;
-  z<C> r;
-  r.digits.reserve(std::max(std::ranges::size(lhs.digits), std::ranges::size(rhs.digits)) + 1);
-
-  const auto& [a, b] = std::ranges::size(lhs.digits) <= std::ranges::size(rhs.digits)
-                           ? std::tie(lhs.digits, rhs.digits)
-                           : std::tie(rhs.digits, lhs.digits);
+// r = a + b, where |r| == |a| >= |b|. Returns the carry out of r.
+template <class D>
+constexpr D add_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  assert(r.size() == a.size() && a.size() >= b.size());
+#if defined(EPSILON_HAS_ADDCARRY)
+  if constexpr (sizeof(D) == sizeof(uint32_t) || sizeof(D) == sizeof(uint64_t)) {
+    if !consteval {
+      return add_limbs_adc(r.data(), a.data(), b.data(), a.size(), b.size());
+    }
+  }
+#endif
   size_t i = 0;
   D cy = 0;
-  for (; i < std::ranges::size(a); ++i) {
+  for (; i < b.size(); ++i) {
     D s1 = a[i] + b[i];
     D cy1 = s1 < a[i];
     D s2 = s1 + cy;
     D cy2 = s2 < s1;
     cy = cy1 | cy2;
-    r.digits.push_back(s2);
+    r[i] = s2;
   }
-  for (; i < std::ranges::size(b); ++i) {
-    D s = b[i] + cy;
-    cy = s < b[i];
-    r.digits.push_back(s);
-  }
-  if (cy > 0) {
-    r.digits.push_back(1u);
+  for (; i < a.size(); ++i) {
+    D s = a[i] + cy;
+    cy = s < a[i];
+    r[i] = s;
   }
-  return r;
+  return cy;
 }
 
-template <container C>
-constexpr z<C> sub_n(const z<C>& lhs, const z<C>& rhs) {
-  assert(std::ranges::size(lhs.digits) >= std::ranges::size(rhs.digits));
-  using D = typename z<C>::digit_type;
-  z<C> r;
-  const auto& a = lhs.digits;
-  const auto& b = rhs.digits;
-
-  r.digits.reserve(a.size());
-  D borrow = 0;
+// r = a - b, where |r| == |a| >= |b|. Returns the borrow out of r.
+template <class D>
+constexpr D sub_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  assert(r.size() == a.size() && a.size() >= b.size());
+#if defined(EPSILON_HAS_ADDCARRY)
+  if constexpr (sizeof(D) == sizeof(uint32_t) || sizeof(D) == sizeof(uint64_t)) {
+    if !consteval {
+      return sub_limbs_sbb(r.data(), a.data(), b.data(), a.size(), b.size());
+    }
+  }
+#endif
   size_t i = 0;
-
+  D borrow = 0;
   for (; i < b.size(); ++i) {
     D d1 = a[i];
     D d2 = b[i];
-    D diff = d1 - d2 - borrow;
+    r[i] = d1 - d2 - borrow;
     borrow = borrow ? (d1 <= d2) : (d1 < d2);
-    r.digits.push_back(diff);
   }
   for (; i < a.size(); ++i) {
     D d1 = a[i];
-    D diff = d1 - borrow;
+    r[i] = d1 - borrow;
     borrow = (d1 < borrow);
-    r.digits.push_back(diff);
   }
-  assert(borrow == 0);
-  normalize(r);
-  return r;
+  return borrow;
 }
 
-template <container C>
-constexpr z<C> mul_n(const z<C>& lhs, const z<C>& rhs) {
-  using D = typename z<C>::digit_type;
-  if (is_zero(lhs) || is_zero(rhs)) {
-    return details::zero<C>();
+// Compares a and b by value, where |a| >= |b|.
+template <class D>
+constexpr int cmp_limbs(std::span<const D> a, std::span<const D> b) {
+  assert(a.size() >= b.size());
+  for (auto i = a.size(); i > b.size(); --i) {
+    if (a[i - 1] != 0) return 1;
+  }
+  for (auto i = b.size(); i > 0; --i) {
+    if (a[i - 1] != b[i - 1]) return a[i - 1] < b[i - 1] ? -1 : 1;
   }
+  return 0;
+}
 
-  z<C> r;
-  r.digits.resize(std::ranges::size(lhs.digits) + std::ranges::size(rhs.digits));
+// r = |a - b|, where |r| == |a| >= |b|. Returns true if a < b.
+template <class D>
+constexpr bool abs_diff_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  if (cmp_limbs(a, b) >= 0) {
+    sub_limbs(r, a, b);
+    return false;
+  }
+  // a < b implies the digits of a above |b| are all zero.
+  sub_limbs(r.first(b.size()), b, a.first(b.size()));
+  std::ranges::fill(r.subspan(b.size()), D{0});
+  return true;
+}
 
-  const auto& a = lhs.digits;
-  const auto& b = rhs.digits;
-  for (size_t j = 0; j < std::ranges::size(b); ++j) {
-    D cy = 0;
-    for (size_t i = 0; i < std::ranges::size(a); ++i) {
-      auto [p0, p1] = details::umul<default_digit_type>(a[i], b[j]);
-      p0 += cy;
-      cy = (p0 < cy ? 1u : 0u) + p1;
-      r.digits[i + j] += p0;
-      if (r.digits[i + j] < p0) ++cy;
+// r += a * v, where |r| == |a|. Returns the carry out of r. The portable loop behind
+// addmul_1_limbs.
+template <class D>
+constexpr D addmul_1_limbs_generic(std::span<D> r, std::span<const D> a, D v) {
+  assert(r.size() == a.size());
+#if defined(EPSILON_HAS_ADDCARRY)
+  if constexpr (sizeof(D) == sizeof(uint32_t) || sizeof(D) == sizeof(uint64_t)) {
+    if !consteval {
+      return addmul_1_adc(r.data(), a.data(), a.size(), v);
     }
-    r.digits[j + std::ranges::size(a)] = cy;
   }
-  normalize(r);
-  return r;
+#endif
+  D cy = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    auto [p0, p1] = umul(a[i], v);
+    p0 += cy;
+    cy = (p0 < cy ? 1u : 0u) + p1;
+    r[i] += p0;
+    if (r[i] < p0) ++cy;
+  }
+  return cy;
 }
 
-template <container C>
-constexpr auto div_n(const z<C>& u, typename z<C>::digit_type v) {
-  using D = typename z<C>::digit_type;
-  static_assert(sizeof(D) <= sizeof(max_digit_type));
-
-  struct {
-    z<C> q;
-    D r;
-  } res{};
-
-  auto& w = res.q.digits;
-  auto n = std::ranges::size(u.digits);
-  w.resize(n);
-  for (auto i = 0uz; i < n; ++i) {
-    auto j = n - 1 - i;
-    auto [q, r] = details::div_2d(u.digits[j], res.r, v);
-    w[j] = static_cast<D>(q);
-    res.r = r;
+// r += a * v, where |r| == |a|. Returns the carry out of r. Dispatched as mul_basecase.
+template <class D>
+constexpr D addmul_1_limbs(std::span<D> r, std::span<const D> a, D v) {
+  if constexpr (std::same_as<D, default_digit_type>) {
+    if !consteval {
+      if (const auto* k = core::active_kernels) {
+        assert(r.size() == a.size());
+        return k->addmul_1(r.data(), a.data(), a.size(), v);
+      }
+    }
   }
-  normalize(res.q);
-  return res;
+  return addmul_1_limbs_generic(r, a, v);
 }
 
-template <container C>
-constexpr auto div_n(z<C> lhs, z<C> rhs) {
-  struct result_t {
-    z<C> q;
-    z<C> r;
-  };
-
-  if (is_zero(rhs)) [[unlikely]] {
-    throw divide_by_zero_error{};
+// r = a * b (schoolbook), where |r| == |a| + |b|. r must not overlap a or b. The portable loop
+// behind mul_basecase.
+template <class D>
+constexpr void mul_basecase_generic(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  assert(r.size() == a.size() + b.size());
+  std::ranges::fill(r.first(a.size()), D{0});
+  for (size_t j = 0; j < b.size(); ++j) {
+    r[j + a.size()] = addmul_1_limbs_generic(r.subspan(j, a.size()), a, b[j]);
   }
+}
 
-  auto rel = cmp_n(lhs, rhs);
-  if (rel > 0) {
-    if (std::ranges::size(rhs.digits) > 1) {
-      using D = typename z<C>::digit_type;
-      using W = wide_digit_type<D>;
-      constexpr W b = W{1} << (sizeof(D) * CHAR_BIT);
-      constexpr D mask = D{b - 1};
+// r = a * b (schoolbook), where |r| == |a| + |b|. r must not overlap a or b. When linked with
+// epsilon_core, default_digit_type digits take the kernel selected for the host CPU.
+template <class D>
+constexpr void mul_basecase(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  if constexpr (std::same_as<D, default_digit_type>) {
+    if !consteval {
+      if (const auto* k = core::active_kernels) {
+        assert(r.size() == a.size() + b.size());
+        k->mul_basecase(r.data(), a.data(), a.size(), b.data(), b.size());
+        return;
+      }
+    }
+  }
+  mul_basecase_generic(r, a, b);
+}
 
-      auto& u = lhs.digits;
-      auto& v = rhs.digits;
-      auto n = std::ranges::size(v);
-      auto m = std::ranges::size(u) - n;
+enum class mul_algo : uint8_t { basecase, karatsuba, toom3, toom4, ntt, unbalanced };
 
-      z<C> q;
-      q.digits.resize(m + 1);
+// Number of 32-bit NTT coefficients holding n digits.
+template <class D>
+constexpr size_t ntt_size(size_t n) {
+  return (n * sizeof(D) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+}
 
-      // D1. [Normalize]
-      const auto s = std::countl_zero(v[n - 1]);
-      details::bit_shift(v, (int)s);
-      u.push_back(details::bit_shift(u, (int)s));  // this ensures u[m+n] exists.
-
-      // D2. [Initialize j]
-      for (auto l = 0uz; l <= m; ++l) {
-        auto j = m - l;
-
-        // D3. [Calculate qhat]
-        auto [qhat, rhat] = details::div_2d(u[j + n - 1], u[j + n], v[n - 1]);
-        while (qhat >= b || qhat * v[n - 2] > rhat * b + u[j + n - 2]) {
-          --qhat;
-          rhat += v[n - 1];
-          if (rhat < v[n - 1]) break;  // continue if rhat < b.
-        }
+// Selects the multiplication kernel for an |a| x |b| product, with |a| >= |b|. A Toom-k kernel
+// splits both operands into k pieces of ceil(|a|/k) digits, so |b| must be long enough to fill
+// its top piece. Products too long for a single transform are split by the Toom tiers until the
+// pieces fit. A b too short for Karatsuba on a but not for schoolbook multiplies |b|-digit pieces
+// of a.
+template <class D>
+constexpr mul_algo select_mul(size_t an, size_t bn) {
+  if (bn >= ntt_threshold<global_config_tag> &&
+      ntt::length(ntt_size<D>(an), ntt_size<D>(bn)) <= ntt::max_length) {
+    return mul_algo::ntt;
+  }
+  if (bn >= toom4_threshold<global_config_tag> && bn > 3 * ((an + 3) / 4)) {
+    return mul_algo::toom4;
+  }
+  if (bn >= toom3_threshold<global_config_tag> && bn > 2 * ((an + 2) / 3)) {
+    return mul_algo::toom3;
+  }
+  if (bn >= karatsuba_threshold<global_config_tag>) {
+    return bn > (an + 1) / 2 ? mul_algo::karatsuba : mul_algo::unbalanced;
+  }
+  return mul_algo::basecase;
+}
 
-        // D4. [Multiply and subtract]
-        using I = std::make_signed_t<W>;
-        I borrow = 0, diff;
-        for (auto i = 0uz; i < n; ++i) {  // u[j+n]u[j+n-1]...u[j], v[n-1]v[n-2]...v[0]
-          W p = qhat * v[i];
-          diff = W{u[i + j]} - borrow - static_cast<W>(p & mask);
-          u[i + j] = static_cast<D>(diff);
-          borrow = (p >> (sizeof(D) * CHAR_BIT)) - (diff >> (sizeof(D) * CHAR_BIT));
-        }
-        diff = I{u[j + n]} - borrow;
-        u[j + n] = static_cast<D>(diff);
-        q.digits[j] = static_cast<D>(qhat);
-
-        // D5. [Test remainder]
-        if (diff < 0) {
-          // D6. [Add back]
-          --q.digits[j];
-          I carry = 0;
-          for (auto i = 0uz; i < n; ++i) {
-            W sum = W{u[i + j]} + W{v[i]} + carry;
-            u[i + j] = static_cast<D>(sum);
-            carry = sum >> (sizeof(D) * CHAR_BIT);
-          }
-          u[j + n] = u[j + n] + static_cast<D>(carry);
-        }
-      }  // D7. [Loop on j]
-      // D8. [Unnormalize]
-      details::bit_shift(u, -s);
-      normalize(lhs);
-      return result_t{.q = std::move(normalize(q)), .r = std::move(lhs)};
-    } else {
-      assert(std::ranges::size(rhs.digits) == 1);
-      auto res = div_n(lhs, rhs.digits[0]);
-      z<C> r{.digits = {res.r}};
-      normalize(r);
-      return result_t{.q = std::move(res.q), .r = std::move(r)};
-    }
-  } else if (rel < 0) {
-    return result_t{.q = details::zero<C>(), .r = std::move(lhs)};
-  } else {
-    return result_t{.q = details::one<C>(), .r = details::zero<C>()};
+// Number of scratch digits mul_limbs and sqr_limbs need for an |a| x |b| product, with |a| >= |b|.
+// The Toom tiers keep their evaluated operands in their own temporaries and need no scratch.
+template <class D>
+constexpr size_t mul_limbs_scratch(size_t an, size_t bn) {
+  const auto algo = select_mul<D>(an, bn);
+  if (algo == mul_algo::unbalanced) {
+    // a piece product, then the scratch of the |b| x |b| pieces and of the last, shorter one
+    return 2 * bn + std::max(mul_limbs_scratch<D>(bn, bn), an % bn == 0 ? 0 : mul_limbs_scratch<D>(bn, an % bn));
   }
+  if (algo != mul_algo::karatsuba) {
+    return 0;
+  }
+  size_t h = (an + 1) / 2;
+  return std::max(4 * h + std::max(size_t{1}, mul_limbs_scratch<D>(h, h)), mul_limbs_scratch<D>(an - h, bn - h));
 }
 
-template <container C>
-constexpr z<C> add(const z<C>& lhs, const z<C>& rhs) {
-  z<C> r;
-  if (lhs.sgn == rhs.sgn) {
-    r = add_n(lhs, rhs);
-    r.sgn = lhs.sgn;
+template <class D>
+constexpr void mul_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b, std::span<D> ws);
+
+// Karatsuba (balanced Toom-2) product. With a = a1*B^h + a0 and b = b1*B^h + b0:
+//   a*b = a1*b1*B^2h + (a0*b0 + a1*b1 - (a0 - a1)*(b0 - b1))*B^h + a0*b0
+// Requires |a| >= |b| > h = ceil(|a|/2). ws holds at least mul_limbs_scratch(|a|, |b|) digits.
+template <class D>
+constexpr void mul_karatsuba(std::span<D> r, std::span<const D> a, std::span<const D> b, std::span<D> ws) {
+  const size_t h = (a.size() + 1) / 2;
+  assert(a.size() >= b.size() && b.size() > h);
+  auto a0 = a.first(h), a1 = a.subspan(h);
+  auto b0 = b.first(h), b1 = b.subspan(h);
+
+  // r = a1*b1*B^2h + a0*b0
+  mul_limbs(r.first(2 * h), a0, b0, ws);
+  mul_limbs(r.subspan(2 * h), a1, b1, ws);
+
+  // v = |a0 - a1| * |b0 - b1|
+  auto v = ws.first(2 * h);
+  auto t = ws.subspan(2 * h, h);
+  auto u = ws.subspan(3 * h, h);
+  bool neg = abs_diff_limbs<D>(t, a0, a1) != abs_diff_limbs<D>(u, b0, b1);
+  mul_limbs<D>(v, t, u, ws.subspan(4 * h));
+
+  // w = a0*b0 + a1*b1 -/+ v, which is the non-negative middle coefficient a0*b1 + a1*b0.
+  auto w = ws.subspan(2 * h, 2 * h + 1);
+  w[2 * h] = add_limbs<D>(w.first(2 * h), r.first(2 * h), r.subspan(2 * h));
+  if (neg) {
+    add_limbs<D>(w, w, v);
   } else {
-    const auto* minuend = &lhs;
-    const auto* substrahend = &rhs;
-    if (cmp_n(lhs, rhs) < 0) {
-      minuend = &rhs;
-      substrahend = &lhs;
-    }
-    r = sub_n(*minuend, *substrahend);
-    r.sgn = std::ranges::size(r.digits) > 0 ? minuend->sgn : sign::positive;
+    sub_limbs<D>(w, w, v);
   }
-  return r;
+
+  // r += w*B^h; the product fits in |a| + |b| digits, so any truncated top digit of w is zero.
+  auto hi = r.subspan(h);
+  auto wn = std::min(w.size(), hi.size());
+  assert(wn == w.size() || w[wn] == 0);
+  [[maybe_unused]] D cy = add_limbs<D>(hi, hi, w.first(wn));
+  assert(cy == 0);
 }
 
-template <container C>
-constexpr z<C> sub(const z<C>& lhs, z<C> rhs) {
-  return add(lhs, negate(rhs));
+// Digits [i*k, (i+1)*k) of s as a normalized integer.
+template <class D>
+constexpr z<std::vector<D>> toom_piece(std::span<const D> s, size_t i, size_t k) {
+  auto first = std::min(i * k, s.size());
+  auto last = std::min(first + k, s.size());
+  z<std::vector<D>> v{.digits = std::vector<D>(s.begin() + first, s.begin() + last)};
+  return normalize(v);
 }
 
+template <class D>
+constexpr z<std::vector<D>> toom_mul_small(const z<std::vector<D>>& v, unsigned m) {
+  return mul(v, create<std::vector<D>>(m));
+}
+
+// Exact division of a signed integer by a small constant.
+template <class D>
+constexpr z<std::vector<D>> toom_divexact(const z<std::vector<D>>& v, D d) {
+  auto [q, rem] = div_n(v, d);
+  assert(rem == 0);
+  q.sgn = v.sgn;
+  return normalize(q);
+}
+
+// r = sum(c[i] * B^(i*k)), where every c[i] is non-negative and the sum fits in r.
+template <class D>
+constexpr void toom_recompose(std::span<D> r, std::span<const z<std::vector<D>>> c, size_t k) {
+  std::ranges::fill(r, D{0});
+  for (size_t i = 0; i < c.size(); ++i) {
+    assert(!is_negative(c[i]));
+    if (is_zero(c[i])) continue;
+    auto dst = r.subspan(i * k);
+    [[maybe_unused]] D cy = add_limbs<D>(dst, dst, c[i].digits);
+    assert(cy == 0);
+  }
+}
+
+// Toom-3 evaluation of p(x) = p0 + p1*x + p2*x^2 at 0, 1, -1, 2 and infinity.
+template <class D>
+constexpr std::array<z<std::vector<D>>, 5> toom3_eval(std::span<const D> s, size_t k) {
+  const auto p0 = toom_piece(s, 0, k), p1 = toom_piece(s, 1, k), p2 = toom_piece(s, 2, k);
+  const auto p02 = add(p0, p2);
+  return {p0, add(p02, p1), sub(p02, p1), add(p0, mul_2exp(add(p1, mul_2exp(p2, 1)), 1)), p2};
+}
+
+// Toom-4 evaluation of p(x) = p0 + p1*x + p2*x^2 + p3*x^3 at 0, 1, -1, 2, -2, 3 and infinity, with
+// p(+-1) = (p0 + p2) +- (p1 + p3) and p(+-2) = (p0 + 4*p2) +- 2*(p1 + 4*p3).
+template <class D>
+constexpr std::array<z<std::vector<D>>, 7> toom4_eval(std::span<const D> s, size_t k) {
+  const auto p0 = toom_piece(s, 0, k), p1 = toom_piece(s, 1, k), p2 = toom_piece(s, 2, k), p3 = toom_piece(s, 3, k);
+  const auto e1 = add(p0, p2), o1 = add(p1, p3);
+  const auto e2 = add(p0, mul_2exp(p2, 2)), o2 = mul_2exp(add(p1, mul_2exp(p3, 2)), 1);
+  const auto v3 = add(p0, toom_mul_small(add(p1, toom_mul_small(add(p2, toom_mul_small(p3, 3)), 3)), 3));
+  return {p0, add(e1, o1), sub(e1, o1), add(e2, o2), sub(e2, o2), v3, p3};
+}
+
+// Multiplies the evaluated points pairwise, or squares them when both operands are the same.
+template <class D, class Eval>
+constexpr auto toom_points(std::span<const D> a, std::span<const D> b, size_t k, Eval eval) {
+  auto c = eval(a, k);
+  if (a.data() == b.data() && a.size() == b.size()) {
+    for (auto& v : c) v = sqr(v);
+  } else {
+    const auto vb = eval(b, k);
+    for (size_t i = 0; i < c.size(); ++i) c[i] = mul(c[i], vb[i]);
+  }
+  return c;
+}
+
+// Toom-3 product. With c(x) = a(x)*b(x) = sum(c[i]*x^i):
+//   c1 + c3 = (c(1) - c(-1)) / 2, c2 = (c(1) + c(-1)) / 2 - c0 - c4,
+//   c1 + 4*c3 = (c(2) - c0 - 4*c2 - 16*c4) / 2.
+template <class D>
+constexpr void mul_toom3(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  using Z = z<std::vector<D>>;
+  const size_t k = (a.size() + 2) / 3;
+  assert(a.size() >= b.size() && b.size() > 2 * k);
+
+  const auto [r0, r1, rm1, r2, rinf] = toom_points<D>(a, b, k, toom3_eval<D>);
+  const auto o1 = mul_2exp(sub(r1, rm1), -1);
+  const auto c2 = sub(sub(mul_2exp(add(r1, rm1), -1), r0), rinf);
+  const auto t = mul_2exp(sub(sub(sub(r2, r0), mul_2exp(c2, 2)), mul_2exp(rinf, 4)), -1);
+  const auto c3 = toom_divexact<D>(sub(t, o1), 3);
+  const auto c1 = sub(o1, c3);
+
+  const Z c[] = {r0, c1, c2, c3, rinf};
+  toom_recompose<D>(r, c, k);
+}
+
+// Toom-4 product. The even coefficients follow from the symmetric sums at +-1 and +-2, and the odd
+// ones from a 3x3 Vandermonde system in 1, 4, 9:
+//   c1 + c3 + c5 = (c(1) - c(-1)) / 2, c1 + 4*c3 + 16*c5 = (c(2) - c(-2)) / 4,
+//   c1 + 9*c3 + 81*c5 = (c(3) - c0 - 9*c2 - 81*c4 - 729*c6) / 3.
+template <class D>
+constexpr void mul_toom4(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  using Z = z<std::vector<D>>;
+  const size_t k = (a.size() + 3) / 4;
+  assert(a.size() >= b.size() && b.size() > 3 * k);
+
+  const auto [r0, r1, rm1, r2, rm2, r3, rinf] = toom_points<D>(a, b, k, toom4_eval<D>);
+
+  // interpolate the even coefficients
+  const auto e2 = sub(sub(mul_2exp(add(r1, rm1), -1), r0), rinf);               // c2 + c4
+  const auto e4 = sub(sub(mul_2exp(add(r2, rm2), -1), r0), mul_2exp(rinf, 6));  // 4*c2 + 16*c4
+  const auto c4 = toom_divexact<D>(sub(e4, mul_2exp(e2, 2)), 12);
+  const auto c2 = sub(e2, c4);
+
+  // interpolate the odd coefficients
+  const auto o1 = mul_2exp(sub(r1, rm1), -1);
+  const auto o2 = mul_2exp(sub(r2, rm2), -2);
+  const auto s3 = sub(sub(sub(sub(r3, r0), toom_mul_small(c2, 9)), toom_mul_small(c4, 81)), toom_mul_small(rinf, 729));
+  const auto o3 = toom_divexact<D>(s3, 3);
+  const auto d1 = toom_divexact<D>(sub(o2, o1), 3);  // c3 + 5*c5
+  const auto d2 = toom_divexact<D>(sub(o3, o2), 5);  // c3 + 13*c5
+  const auto c5 = mul_2exp(sub(d2, d1), -3);
+  const auto c3 = sub(d1, toom_mul_small(c5, 5));
+  const auto c1 = sub(sub(o1, c3), c5);
+
+  const Z c[] = {r0, c1, c2, c3, c4, c5, rinf};
+  toom_recompose<D>(r, c, k);
+}
+
+// Packs digits into the 32-bit coefficients of an NTT operand.
+template <class D>
+constexpr std::vector<uint32_t> ntt_pack(std::span<const D> s) {
+  std::vector<uint32_t> c(ntt_size<D>(s.size()));
+  if constexpr (sizeof(D) >= sizeof(uint32_t)) {
+    constexpr size_t per = sizeof(D) / sizeof(uint32_t);
+    for (size_t i = 0; i < s.size(); ++i) {
+      for (size_t k = 0; k < per; ++k) {
+        c[i * per + k] = static_cast<uint32_t>(s[i] >> (k * 32));
+      }
+    }
+  } else {
+    constexpr size_t per = sizeof(uint32_t) / sizeof(D);
+    for (size_t i = 0; i < s.size(); ++i) {
+      c[i / per] |= uint32_t{s[i]} << (i % per * sizeof(D) * CHAR_BIT);
+    }
+  }
+  return c;
+}
+
+// Unpacks the 32-bit coefficients of an NTT product into digits.
+template <class D>
+constexpr void ntt_unpack(std::span<D> r, std::span<const uint32_t> c) {
+  if constexpr (sizeof(D) >= sizeof(uint32_t)) {
+    constexpr size_t per = sizeof(D) / sizeof(uint32_t);
+    for (size_t i = 0; i < r.size(); ++i) {
+      D d = 0;
+      for (size_t k = 0; k < per; ++k) {
+        d |= static_cast<D>(c[i * per + k]) << (k * 32);
+      }
+      r[i] = d;
+    }
+  } else {
+    constexpr size_t per = sizeof(uint32_t) / sizeof(D);
+    for (size_t i = 0; i < r.size(); ++i) {
+      r[i] = static_cast<D>(c[i / per] >> (i % per * sizeof(D) * CHAR_BIT));
+    }
+  }
+}
+
+// Product through the three-prime number-theoretic transform in ntt.hpp, O(n log n).
+template <class D>
+constexpr void mul_ntt(std::span<D> r, std::span<const D> a, std::span<const D> b) {
+  std::vector<uint32_t> c(ntt_size<D>(r.size()));
+  const auto ca = ntt_pack(a);
+  if (a.data() == b.data() && a.size() == b.size()) {
+    ntt::multiply(c, ca, ca);
+  } else {
+    ntt::multiply(c, ca, ntt_pack(b));
+  }
+  ntt_unpack<D>(r, c);
+}
+
+// Product of a and the operand prepared in tb through the number-theoretic transform, where |r| is
+// |a| plus the digits of that operand.
+template <class D>
+constexpr void mul_ntt(std::span<D> r, std::span<const D> a, const ntt::transform& tb) {
+  std::vector<uint32_t> c(ntt_size<D>(r.size()));
+  ntt::multiply(c, ntt_pack(a), tb);
+  ntt_unpack<D>(r, c);
+}
+
+// r = 2r + the diagonal squares a[i]^2 at digit 2i, where |r| == 2*|a| and r holds cross products
+// of a, so that the result fits. Completes the schoolbook squares below.
+template <class D>
+constexpr void add_sqr_diagonal(std::span<D> r, std::span<const D> a) {
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  const size_t n = a.size();
+  assert(r.size() == 2 * n);
+  D top = 0;
+  for (auto& d : r) {
+    D t = static_cast<D>(d << 1) | top;
+    top = d >> (dbits - 1);
+    d = t;
+  }
+
+  D cy = 0;
+  for (size_t i = 0; i < n; ++i) {
+    auto [p0, p1] = umul(a[i], a[i]);
+    D s0 = r[2 * i] + p0;
+    D c0 = s0 < p0;
+    s0 += cy;
+    c0 += s0 < cy;
+    D s1 = r[2 * i + 1] + p1;
+    D c1 = s1 < p1;
+    s1 += c0;
+    c1 += s1 < c0;
+    r[2 * i] = s0;
+    r[2 * i + 1] = s1;
+    cy = c1;
+  }
+  assert(cy == 0);
+}
+
+// r = a^2 (schoolbook), where |r| == 2*|a|. Each cross product a[i]*a[j], i < j, is computed once
+// and doubled, then the diagonal squares are added. r must not overlap a. The portable loop behind
+// sqr_basecase.
+template <class D>
+constexpr void sqr_basecase_generic(std::span<D> r, std::span<const D> a) {
+  const size_t n = a.size();
+  assert(r.size() == 2 * n);
+  std::ranges::fill(r, D{0});
+  for (size_t i = 0; i + 1 < n; ++i) {
+    r[i + n] = addmul_1_limbs_generic(r.subspan(2 * i + 1, n - i - 1), a.subspan(i + 1), a[i]);
+  }
+  add_sqr_diagonal(r, a);
+}
+
+// r = a^2 (schoolbook), where |r| == 2*|a|. r must not overlap a. Dispatched as mul_basecase.
+template <class D>
+constexpr void sqr_basecase(std::span<D> r, std::span<const D> a) {
+  if constexpr (std::same_as<D, default_digit_type>) {
+    if !consteval {
+      if (const auto* k = core::active_kernels) {
+        assert(r.size() == 2 * a.size());
+        k->sqr_basecase(r.data(), a.data(), a.size());
+        return;
+      }
+    }
+  }
+  sqr_basecase_generic(r, a);
+}
+
+template <class D>
+constexpr void sqr_limbs(std::span<D> r, std::span<const D> a, std::span<D> ws);
+
+// Karatsuba square: a^2 = a1^2*B^2h + (a0^2 + a1^2 - (a0 - a1)^2)*B^h + a0^2, three half-size
+// squares instead of three general products. ws holds at least mul_limbs_scratch(|a|, |a|) digits.
+template <class D>
+constexpr void sqr_karatsuba(std::span<D> r, std::span<const D> a, std::span<D> ws) {
+  const size_t h = (a.size() + 1) / 2;
+  auto a0 = a.first(h), a1 = a.subspan(h);
+
+  sqr_limbs(r.first(2 * h), a0, ws);
+  sqr_limbs(r.subspan(2 * h), a1, ws);
+
+  auto v = ws.first(2 * h);
+  auto t = ws.subspan(2 * h, h);
+  abs_diff_limbs<D>(t, a0, a1);
+  sqr_limbs<D>(v, t, ws.subspan(4 * h));
+
+  auto w = ws.subspan(2 * h, 2 * h + 1);
+  w[2 * h] = add_limbs<D>(w.first(2 * h), r.first(2 * h), r.subspan(2 * h));
+  sub_limbs<D>(w, w, v);
+
+  auto hi = r.subspan(h);
+  auto wn = std::min(w.size(), hi.size());
+  assert(wn == w.size() || w[wn] == 0);
+  [[maybe_unused]] D cy = add_limbs<D>(hi, hi, w.first(wn));
+  assert(cy == 0);
+}
+
+// r = a * b for |a| > 2*|b|, where |r| == |a| + |b|: a is cut into |b|-digit pieces, and each
+// balanced piece product is added into r at its offset, so the work grows linearly with |a|. ws
+// holds at least mul_limbs_scratch(|a|, |b|) digits.
+template <class D>
+constexpr void mul_unbalanced(std::span<D> r, std::span<const D> a, std::span<const D> b, std::span<D> ws) {
+  const size_t n = b.size();
+  mul_limbs(r.first(2 * n), a.first(n), b, ws.subspan(2 * n));
+  std::ranges::fill(r.subspan(2 * n), D{0});
+  auto p = ws.first(2 * n);
+  for (size_t i = n; i < a.size(); i += n) {
+    // r is zero from i + n on, so the sum stays within the piece product
+    const size_t m = std::min(n, a.size() - i);
+    auto pi = p.first(m + n);
+    mul_limbs<D>(pi, a.subspan(i, m), b, ws.subspan(2 * n));
+    auto ri = r.subspan(i, m + n);
+    [[maybe_unused]] D cy = add_limbs<D>(ri, ri, pi);
+    assert(cy == 0);
+  }
+}
+
+// r = a^2, where |r| == 2*|a|. Uses the same tiers and crossovers as mul_limbs.
+template <class D>
+constexpr void sqr_limbs(std::span<D> r, std::span<const D> a, std::span<D> ws) {
+  switch (select_mul<D>(a.size(), a.size())) {
+    case mul_algo::ntt:
+      mul_ntt(r, a, a);
+      break;
+    case mul_algo::toom4:
+      mul_toom4(r, a, a);
+      break;
+    case mul_algo::toom3:
+      mul_toom3(r, a, a);
+      break;
+    case mul_algo::karatsuba:
+      sqr_karatsuba(r, a, ws);
+      break;
+    case mul_algo::unbalanced:
+    case mul_algo::basecase:
+      sqr_basecase(r, a);
+      break;
+  }
+}
+
+// r = a * b, where |r| == |a| + |b|. Selects the multiplication kernel by operand size.
+template <class D>
+constexpr void mul_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b, std::span<D> ws) {
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+  switch (select_mul<D>(a.size(), b.size())) {
+    case mul_algo::ntt:
+      mul_ntt(r, a, b);
+      break;
+    case mul_algo::toom4:
+      mul_toom4(r, a, b);
+      break;
+    case mul_algo::toom3:
+      mul_toom3(r, a, b);
+      break;
+    case mul_algo::karatsuba:
+      mul_karatsuba(r, a, b, ws);
+      break;
+    case mul_algo::unbalanced:
+      mul_unbalanced(r, a, b, ws);
+      break;
+    case mul_algo::basecase:
+      mul_basecase(r, a, b);
+      break;
+  }
+}
+
+// Short product: r = a * b less some of the partial products a[i] * b[j] with i + j < t, where
+// |r| == |a| + |b|. This one leaves out exactly those below t.
+template <class D>
+constexpr void mul_high_basecase(std::span<D> r, std::span<const D> a, std::span<const D> b, size_t t) {
+  assert(r.size() == a.size() + b.size());
+  std::ranges::fill(r.first(a.size()), D{0});
+  for (size_t j = 0; j < b.size(); ++j) {
+    const size_t i = t > j ? std::min(t - j, a.size()) : 0;
+    r[j + a.size()] = addmul_1_limbs(r.subspan(i + j, a.size() - i), a.subspan(i), b[j]);
+  }
+}
+
+// Short square: r = a^2 less the cross products a[i] * a[j], i != j, with i + j < t, where
+// |r| == 2*|a|. Laid out as sqr_basecase.
+template <class D>
+constexpr void sqr_high_basecase(std::span<D> r, std::span<const D> a, size_t t) {
+  const size_t n = a.size();
+  assert(r.size() == 2 * n);
+  std::ranges::fill(r, D{0});
+  for (size_t i = 0; i + 1 < n; ++i) {
+    const size_t j = std::max(i + 1, t > i ? std::min(t - i, n) : 0);
+    r[i + n] = addmul_1_limbs(r.subspan(i + j, n - j), a.subspan(j), a[i]);
+  }
+  add_sqr_diagonal(r, a);
+}
+
+// Number of scratch digits mul_high_limbs needs for an |a| x |b| product short below t: the most
+// that its full product and either of its short products take.
+template <class D>
+constexpr size_t mul_high_scratch(size_t an, size_t bn, size_t t) {
+  if (an < bn) {
+    std::swap(an, bn);
+  }
+  if (t + 1 >= an + bn || bn < karatsuba_threshold<global_config_tag>) {
+    return 0;
+  }
+  const size_t q = std::min(3 * t / 10, bn / 2);
+  size_t n = mul_limbs_scratch<D>(an - q, bn - q);
+  if (q == 0) {
+    return n;
+  }
+  const size_t j0 = std::min(bn, t - q + 1);
+  if (j0 < bn) {
+    n = std::max(n, q + (bn - j0) + mul_high_scratch<D>(q, bn - j0, t - j0));
+  }
+  const size_t i0 = std::max(q, std::min(an, t - q + 1));
+  if (i0 < an) {
+    n = std::max(n, (an - i0) + q + mul_high_scratch<D>(an - i0, q, t - i0));
+  }
+  return n;
+}
+
+// Short product (Mulders, An improved Newton iteration for the functional inverse): r = a * b less
+// some of the partial products a[i] * b[j] with i + j < t, where |r| == |a| + |b|. Those left out
+// sum to less than min(|a|, |b|) * B^(t + 1), for the digit base B. A full product covers
+// a[i] * b[j] for i, j >= q, and two short products the rest, for i < q and for j < q; for a square
+// these two are equal. ws holds at least mul_high_scratch(|a|, |b|, t) digits.
+template <class D>
+constexpr void mul_high_limbs(std::span<D> r, std::span<const D> a, std::span<const D> b, size_t t,
+                              std::span<D> ws) {
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+  const bool square = a.data() == b.data() && a.size() == b.size();
+  const size_t an = a.size(), bn = b.size();
+  if (t + 1 >= an + bn) {
+    std::ranges::fill(r, D{0});
+    return;
+  }
+  if (bn < karatsuba_threshold<global_config_tag>) {
+    if (square) {
+      sqr_high_basecase(r, a, t);
+    } else {
+      mul_high_basecase(r, a, b, t);
+    }
+    return;
+  }
+
+  const size_t q = std::min(3 * t / 10, bn / 2);
+  std::ranges::fill(r.first(2 * q), D{0});
+  if (square) {
+    sqr_limbs<D>(r.subspan(2 * q), a.subspan(q), ws);
+  } else {
+    mul_limbs<D>(r.subspan(2 * q), a.subspan(q), b.subspan(q), ws);
+  }
+  if (q == 0) {
+    return;
+  }
+
+  // r += x * y * B^k, short below t; the full product is done with ws
+  auto add_high = [&](std::span<const D> x, std::span<const D> y, size_t k, int times) {
+    if (x.empty() || y.empty()) return;
+    auto p = ws.first(x.size() + y.size());
+    mul_high_limbs<D>(p, x, y, t - k, ws.subspan(p.size()));
+    auto hi = r.subspan(k);
+    for (int i = 0; i < times; ++i) {
+      [[maybe_unused]] D cy = add_limbs<D>(hi, hi, p);
+      assert(cy == 0);
+    }
+  };
+  // for i < q, only the digits of b from t - q + 1 on reach t, and likewise for j < q
+  const size_t j0 = std::min(bn, t - q + 1);
+  add_high(a.first(q), b.subspan(j0), j0, square ? 2 : 1);
+  if (!square) {
+    const size_t i0 = std::max(q, std::min(an, t - q + 1));
+    add_high(a.subspan(i0), b.first(q), i0, 1);
+  }
+}
+
+template <container C>
+struct div_result {
+  z<C> q;
+  z<C> r;
+};
+
+// dst = the digits of src shifted left by s bits, 0 <= s < the digit width, with |dst| == |src|.
+// Returns the bits shifted out of the top digit.
+template <class D, class R>
+constexpr D lshift_copy(std::span<D> dst, const R& src, int s) {
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  D cy = 0;
+  for (size_t i = 0; i < dst.size(); ++i) {
+    const D d = src[i];
+    dst[i] = s == 0 ? d : static_cast<D>(static_cast<D>(d << s) | cy);
+    cy = s == 0 ? D{0} : static_cast<D>(d >> (dbits - s));
+  }
+  return cy;
+}
+
+// Steps D2-D7 of Knuth's Algorithm D, in place: u holds the dividend shifted left so that the top
+// bit of the divisor v is set, with |u| == |q| + |v|, and vinv = reciprocal_1(v[n - 1]). q receives
+// the quotient and the low |v| digits of u the shifted remainder; the digits above are cleared.
+template <class D>
+constexpr void div_knuth_limbs(std::span<D> q, std::span<D> u, std::span<const D> v, D vinv) {
+  const auto n = v.size();
+  const auto m = q.size() - 1;
+  assert(n > 1 && u.size() == m + n + 1);
+
+  // D2. [Initialize j]
+  for (auto l = 0uz; l <= m; ++l) {
+    auto j = m - l;
+
+    // D3. [Calculate qhat]
+    D qhat;
+    D rhat;
+    bool test = true;
+    if (u[j + n] < v[n - 1]) {
+      auto [q1, r1] = div_2by1(u[j + n], u[j + n - 1], v[n - 1], vinv);
+      qhat = q1;
+      rhat = r1;
+    } else {
+      // the quotient estimate is at least b; start from b - 1, where rhat may overflow.
+      qhat = std::numeric_limits<D>::max();
+      rhat = static_cast<D>(u[j + n - 1] + v[n - 1]);
+      test = rhat >= v[n - 1];
+    }
+    // while qhat * v[n-2] > rhat * b + u[j+n-2], compared digit by digit
+    while (test) {
+      auto [p0, p1] = umul(qhat, v[n - 2]);
+      if (p1 < rhat || (p1 == rhat && p0 <= u[j + n - 2])) break;
+      --qhat;
+      rhat += v[n - 1];
+      if (rhat < v[n - 1]) break;  // continue if rhat < b.
+    }
+
+    // D4. [Multiply and subtract]
+    const auto uj = u.subspan(j, n);
+    D borrow = 0;
+    for (auto i = 0uz; i < n; ++i) {  // u[j+n]u[j+n-1]...u[j], v[n-1]v[n-2]...v[0]
+      auto [p0, p1] = umul(qhat, v[i]);
+      p0 += borrow;
+      p1 += p0 < borrow;
+      D t = uj[i];
+      uj[i] = t - p0;
+      borrow = p1 + (t < p0);  // qhat * v[i] + borrow < B^2 - B, so this cannot wrap
+    }
+    D top = u[j + n];
+    u[j + n] = top - borrow;
+    q[j] = qhat;
+
+    // D5. [Test remainder]
+    if (top < borrow) {
+      // D6. [Add back]
+      --q[j];
+      u[j + n] = u[j + n] + add_limbs<D>(uj, uj, v);
+    }
+  }  // D7. [Loop on j]
+}
+
+// Knuth's Algorithm D for |lhs| >= |v|, where v holds the divisor digits shifted left by s bits so
+// that the top bit is set, and vinv = reciprocal_1(v[n - 1]). The dividend is shifted into scratch
+// as it is read, and the remainder shifted back as it is written out, so q and r, which must be
+// distinct, may be lhs but must not hold the digits of v.
+template <container C>
+constexpr void div_knuth_to(z<C>& q, z<C>& r, const z<C>& lhs, std::span<const typename z<C>::digit_type> v, int s,
+                            typename z<C>::digit_type vinv) {
+  using D = typename z<C>::digit_type;
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+
+  const auto n = v.size();
+  const auto un = std::ranges::size(lhs.digits);
+  assert(n > 1 && un >= n);
+
+  // D1. [Normalize], the top digit ensuring that u[m+n] exists.
+  const scratch_buffer<D> ub(un + 1);
+  const auto u = ub.span();
+  u[un] = lshift_copy(u.first(un), lhs.digits, s);
+
+  q.digits.resize(un - n + 1);
+  q.sgn = sign::positive;
+  if constexpr (std::ranges::contiguous_range<C>) {
+    div_knuth_limbs<D>(std::span<D>{std::ranges::data(q.digits), un - n + 1}, u, v, vinv);
+  } else {
+    const scratch_buffer<D> qb(un - n + 1);
+    div_knuth_limbs<D>(qb, u, v, vinv);
+    std::ranges::copy(qb.span(), std::ranges::begin(q.digits));
+  }
+
+  // D8. [Unnormalize]
+  r.digits.resize(n);
+  r.sgn = sign::positive;
+  for (auto i = 0uz; i < n; ++i) {
+    r.digits[i] = s == 0 ? u[i]
+                         : static_cast<D>((u[i] >> s) | (i + 1 < n ? static_cast<D>(u[i + 1] << (dbits - s)) : 0));
+  }
+  normalize(q);
+  normalize(r);
+}
+
+template <container C>
+constexpr div_result<C> div_knuth(const z<C>& lhs, std::span<const typename z<C>::digit_type> v, int s,
+                                  typename z<C>::digit_type vinv) {
+  div_result<C> res;
+  div_knuth_to(res.q, res.r, lhs, v, s, vinv);
+  return res;
+}
+
+// Schoolbook division of |lhs| by |rhs| != 0: Knuth's Algorithm D, O(|q| * |rhs|). Neither operand
+// is copied; a divisor that needs normalizing is shifted into scratch. The results go into the
+// storage of q and r, which must be distinct and may be lhs, but not rhs.
+template <container C>
+constexpr void div_basecase_to(z<C>& q, z<C>& r, const z<C>& lhs, const z<C>& rhs) {
+  using D = typename z<C>::digit_type;
+  assert(&q != &r && &q != &rhs && &r != &rhs);
+
+  auto rel = cmp_n(lhs, rhs);
+  if (rel > 0) {
+    const auto n = std::ranges::size(rhs.digits);
+    if (n > 1) {
+      // D1. [Normalize]
+      const int s = std::countl_zero(rhs.digits[n - 1]);
+      if constexpr (std::ranges::contiguous_range<C>) {
+        if (s == 0) {
+          div_knuth_to(q, r, lhs, std::span<const D>{std::ranges::data(rhs.digits), n}, 0,
+                       reciprocal_1(rhs.digits[n - 1]));
+          return;
+        }
+      }
+      const scratch_buffer<D> v(n);
+      lshift_copy(v.span(), rhs.digits, s);
+      div_knuth_to(q, r, lhs, v, s, reciprocal_1(v.span()[n - 1]));
+    } else {
+      assert(n == 1);
+      const D rem = div_1(q, lhs, rhs.digits[0]);
+      q.sgn = sign::positive;
+      normalize(q);
+      r.digits.clear();
+      r.sgn = sign::positive;
+      if (rem != 0) r.digits.push_back(rem);
+    }
+  } else if (rel < 0) {
+    r = lhs;
+    q.digits.clear();
+    q.sgn = sign::positive;
+  } else {
+    q.digits.clear();
+    q.digits.push_back(1);
+    q.sgn = sign::positive;
+    r.digits.clear();
+    r.sgn = sign::positive;
+  }
+}
+
+template <container C>
+constexpr div_result<C> div_basecase(const z<C>& lhs, const z<C>& rhs) {
+  div_result<C> res;
+  div_basecase_to(res.q, res.r, lhs, rhs);
+  return res;
+}
+
+// Digits [first, first + count) of |v|.
+template <container C>
+constexpr z<C> digit_slice(const z<C>& v, size_t first, size_t count = SIZE_MAX) {
+  z<C> res;
+  const auto n = std::ranges::size(v.digits);
+  if (first < n) {
+    const auto last = first + std::min(count, n - first);
+    res.digits.reserve(last - first);
+    for (auto i = first; i < last; ++i) res.digits.push_back(v.digits[i]);
+  }
+  return normalize(res);
+}
+
+// |v| mod 2^bits.
+template <container C>
+constexpr z<C> low_bits(const z<C>& v, size_t bits) {
+  using D = typename z<C>::digit_type;
+  constexpr size_t dbits = sizeof(D) * CHAR_BIT;
+  auto res = digit_slice(v, 0, (bits + dbits - 1) / dbits);
+  if (bits % dbits != 0 && std::ranges::size(res.digits) * dbits > bits) {
+    res.digits.back() &= static_cast<D>((D{1} << (bits % dbits)) - 1);
+  }
+  return normalize(res);
+}
+
+// v * B^k, for the digit base B.
+template <container C>
+constexpr z<C> digit_shift(const z<C>& v, size_t k) {
+  z<C> res = v;
+  if (!is_zero(res)) {
+    res.digits.insert(res.digits.begin(), k, 0u);
+  }
+  return res;
+}
+
+template <container C>
+constexpr div_result<C> div_2n1n(const z<C>& a, const z<C>& b, size_t n);
+
+// Burnikel-Ziegler step dividing a 3h-digit a by a normalized 2h-digit b, with a < b * B^h. The
+// quotient estimate from the top digits is at most two too large.
+template <container C>
+constexpr div_result<C> div_3n2n(const z<C>& a, const z<C>& b, size_t h) {
+  using D = typename z<C>::digit_type;
+  const auto b1 = digit_slice(b, h), b2 = digit_slice(b, 0, h);
+  const auto a12 = digit_slice(a, h);
+
+  div_result<C> qr;
+  if (cmp_n(digit_slice(a, 2 * h), b1) < 0) {
+    qr = div_2n1n(a12, b1, h);
+  } else {
+    // q = B^h - 1, r1 = a12 - q * b1 = a12 - b1 * B^h + b1
+    qr.q.digits.resize(h);
+    std::ranges::fill(qr.q.digits, std::numeric_limits<D>::max());
+    qr.r = sub_n(add_n(a12, b1), digit_shift(b1, h));
+  }
+
+  // r = r1 * B^h + a3 - q * b2
+  auto r = sub(add_n(digit_shift(qr.r, h), digit_slice(a, 0, h)), mul_n(qr.q, b2));
+  while (is_negative(r)) {
+    qr.q = sub_n(qr.q, one<C>());
+    r = add(r, b);
+  }
+  qr.r = std::move(r);
+  return qr;
+}
+
+// Divides a < b * B^n by a normalized n-digit b. n halves on each level of the recursion, down to
+// the schoolbook division below bz_threshold.
+template <container C>
+constexpr div_result<C> div_2n1n(const z<C>& a, const z<C>& b, size_t n) {
+  if (n % 2 != 0 || n < bz_threshold<global_config_tag>) {
+    return div_basecase(a, b);
+  }
+  const auto h = n / 2;
+  auto [q1, r1] = div_3n2n(digit_slice(a, h), b, h);
+  auto [q0, r0] = div_3n2n(add_n(digit_shift(r1, h), digit_slice(a, 0, h)), b, h);
+  return {.q = add_n(digit_shift(q1, h), q0), .r = std::move(r0)};
+}
+
+// Burnikel-Ziegler recursive division of |lhs| by |rhs|, O(M(n) log n) for an n-digit divisor.
+// The divisor is scaled to j * 2^k digits with j < bz_threshold and its top bit set, the dividend
+// is cut into blocks of that size, and each block is divided by div_2n1n from the top down.
+template <container C>
+constexpr div_result<C> div_bz(z<C> lhs, z<C> rhs) {
+  const auto sgn = lhs.sgn;
+  lhs.sgn = rhs.sgn = sign::positive;
+
+  const auto n = std::ranges::size(rhs.digits);
+  size_t k = 0;
+  while ((n + (size_t{1} << k) - 1) >> k >= bz_threshold<global_config_tag>) ++k;
+  const auto bn = ((n + (size_t{1} << k) - 1) >> k) << k;
+  const auto pad = bn - n;
+  const int s = std::countl_zero(rhs.digits[n - 1]);
+  rhs = digit_shift(mul_2exp(rhs, s), pad);
+  lhs = digit_shift(mul_2exp(lhs, s), pad);
+
+  const auto blocks = (std::ranges::size(lhs.digits) + bn - 1) / bn;
+  z<C> q, r;
+  q.digits.resize(blocks * bn);
+  for (auto i = blocks; i > 0; --i) {
+    auto [qi, ri] = div_2n1n(add_n(digit_shift(r, bn), digit_slice(lhs, (i - 1) * bn, bn)), rhs, bn);
+    std::ranges::copy(qi.digits, std::ranges::begin(q.digits) + (i - 1) * bn);
+    r = std::move(ri);
+  }
+  normalize(q);
+
+  // Undo the scaling: r is exactly divisible by 2^s * B^pad.
+  r = digit_slice(r, pad);
+  mul_2exp(r, -s);
+  r.sgn = sgn;
+  normalize(r);
+  return {.q = std::move(q), .r = std::move(r)};
+}
+
+// Approximate reciprocal (Brent and Zimmermann, Modern Computer Arithmetic, Algorithm 3.5): for
+// an n-digit a with its top bit set, returns x with a * x < B^2n <= a * (x + 2). Each Newton step
+// lifts the reciprocal of the top half of a to full precision; below a quarter of newton_threshold
+// the reciprocal comes from a division.
+template <container C>
+constexpr z<C> reciprocal(const z<C>& a, size_t n) {
+  if (n < newton_threshold<global_config_tag> / 4) {
+    return div_n(sub_n(digit_shift(one<C>(), 2 * n), one<C>()), a).q;
+  }
+  const auto l = (n - 1) / 2, h = n - l;
+  auto xh = reciprocal(digit_slice(a, l), h);
+  auto t = mul_n(a, xh);
+  const auto bnh = digit_shift(one<C>(), n + h);
+  while (cmp_n(t, bnh) >= 0) {
+    xh = sub_n(xh, one<C>());
+    t = sub_n(t, a);
+  }
+  t = sub_n(bnh, t);
+  const auto u = mul_n(digit_slice(t, l), xh);
+  return add_n(digit_shift(xh, l), digit_slice(u, 2 * h - l));
+}
+
+// Barrett reduction of |lhs| by an n-digit |d| with its top bit set, given x = reciprocal(d, n): two
+// multiplications per divisor-sized block of the dividend below its top n digits. The quotient
+// estimate of a block is at most 4 too small.
+template <container C>
+constexpr div_result<C> div_barrett(const z<C>& lhs, const z<C>& d, const z<C>& x) {
+  const auto n = std::ranges::size(d.digits);
+  const auto un = std::ranges::size(lhs.digits);
+  const auto blocks = un > n ? (un - 1) / n : 0;
+  div_result<C> res;
+  res.q.digits.resize(blocks * n + 1);
+  // the top n digits or fewer are less than 2d
+  res.r = digit_slice(lhs, blocks * n);
+  if (cmp_n(res.r, d) >= 0) {
+    res.r = sub_n(res.r, d);
+    res.q.digits[blocks * n] = 1;
+  }
+  for (auto i = blocks; i > 0; --i) {
+    auto a = add_n(digit_shift(res.r, n), digit_slice(lhs, (i - 1) * n, n));
+    auto qi = digit_slice(mul_n(digit_slice(a, n - 1), x), n + 1);
+    auto r = sub(a, mul_n(qi, d));
+    while (is_negative(r)) {
+      qi = sub_n(qi, one<C>());
+      r = add(r, d);
+    }
+    while (cmp_n(r, d) >= 0) {
+      qi = add_n(qi, one<C>());
+      r = sub_n(r, d);
+    }
+    std::ranges::copy(qi.digits, std::ranges::begin(res.q.digits) + (i - 1) * n);
+    res.r = std::move(r);
+  }
+  normalize(res.q);
+  return res;
+}
+
+// Newton division of |lhs| by |rhs|: one reciprocal of the divisor, then Barrett reduction.
+// A quotient much shorter than the divisor only depends on its top digits, so both operands are
+// truncated first and the estimate corrected against the full divisor.
+template <container C>
+constexpr div_result<C> div_newton(z<C> lhs, z<C> rhs) {
+  const auto sgn = lhs.sgn;
+  lhs.sgn = rhs.sgn = sign::positive;
+
+  auto correct = [&](z<C> q, z<C> a) {
+    auto r = sub(std::move(a), mul_n(q, rhs));
+    while (is_negative(r)) {
+      q = sub_n(q, one<C>());
+      r = add(r, rhs);
+    }
+    while (cmp_n(r, rhs) >= 0) {
+      q = add_n(q, one<C>());
+      r = sub_n(r, rhs);
+    }
+    return div_result<C>{.q = std::move(q), .r = std::move(r)};
+  };
+
+  const auto n = std::ranges::size(rhs.digits);
+  const auto qn = std::ranges::size(lhs.digits) - n;
+  div_result<C> res;
+  if (qn + 2 < n) {
+    const auto d = n - (qn + 2);
+    auto q = div_n(digit_slice(lhs, d), digit_slice(rhs, d)).q;
+    res = correct(std::move(q), std::move(lhs));
+  } else {
+    const int s = std::countl_zero(rhs.digits[n - 1]);
+    mul_2exp(lhs, s);
+    mul_2exp(rhs, s);
+    res = div_barrett(lhs, rhs, reciprocal(rhs, n));
+    mul_2exp(res.r, -s);
+  }
+  res.r.sgn = sgn;
+  normalize(res.r);
+  return res;
+}
+
+}  // namespace details
+
+template <container C, std::integral T>
+constexpr z<C> create(T val) {
+  z<C> res;
+  if (val == 0) {
+    return res;
+  }
+  if constexpr (std::is_signed_v<T>) {
+    res.sgn = val < 0 ? sign::negative : sign::positive;
+    val = val < 0 ? -val : val;
+  }
+  using D = typename z<C>::digit_type;
+  if constexpr (sizeof(T) <= sizeof(D)) {
+    res.digits.push_back(static_cast<D>(val));
+  } else {
+    while (val > 0) {
+      res.digits.push_back(static_cast<D>(val));
+      val >>= (sizeof(D) * CHAR_BIT);
+    }
+  }
+  return res;
+}
+
+template <container C>
+constexpr bool is_zero(const z<C>& num) noexcept {
+  return std::ranges::size(num.digits) == 0;
+}
+
+template <container C>
+constexpr bool is_negative(const z<C>& num) noexcept {
+  return num.sgn == sign::negative;
+}
+
+template <container C>
+constexpr z<C>& normalize(z<C>& num) noexcept {
+  using D = typename z<C>::digit_type;
+  auto pos = std::find_if(num.digits.rbegin(), num.digits.rend(), [](D x) { return x != 0; });
+  num.digits.resize(std::ranges::size(num.digits) - std::ranges::distance(num.digits.rbegin(), pos));
+  num.sgn = num.digits.empty() == false ? num.sgn : sign::positive;
+  return num;
+}
+
+template <container C>
+constexpr z<C>& negate(z<C>& num) noexcept {
+  if (is_zero(num)) {
+    return num;
+  }
+  num.sgn = is_negative(num) ? sign::positive : sign::negative;
+  return num;
+}
+
+template <container C>
+constexpr int cmp_n(const z<C>& lhs, const z<C>& rhs) {
+  if (std::ranges::size(lhs.digits) != std::ranges::size(rhs.digits)) {
+    return std::ranges::size(lhs.digits) < std::ranges::size(rhs.digits) ? -1 : 1;
+  }
+
+  auto res = std::lexicographical_compare_three_way(std::ranges::crbegin(lhs.digits), std::ranges::crend(lhs.digits),
+                                                    std::ranges::crbegin(rhs.digits), std::ranges::crend(rhs.digits));
+  if (res < 0) return -1;
+  if (res > 0) return 1;
+  return 0;
+}
+
+template <container C>
+constexpr z<C> add_n(const z<C>& lhs, const z<C>& rhs) {
+  using D = typename z<C>::digit_type;
+  z<C> r;
+
+  const auto& [a, b] = std::ranges::size(lhs.digits) <= std::ranges::size(rhs.digits)
+                           ? std::tie(lhs.digits, rhs.digits)
+                           : std::tie(rhs.digits, lhs.digits);
+  if constexpr (std::ranges::contiguous_range<C>) {
+    const auto n = std::ranges::size(b);
+    r.digits.resize(n + 1);
+    std::span<D> rs(std::ranges::data(r.digits), n + 1);
+    rs[n] = details::add_limbs<D>(rs.first(n), b, a);
+    if (rs[n] == 0) {
+      r.digits.pop_back();
+    }
+  } else {
+    r.digits.reserve(std::ranges::size(b) + 1);
+    size_t i = 0;
+    D cy = 0;
+    for (; i < std::ranges::size(a); ++i) {
+      D s1 = a[i] + b[i];
+      D cy1 = s1 < a[i];
+      D s2 = s1 + cy;
+      D cy2 = s2 < s1;
+      cy = cy1 | cy2;
+      r.digits.push_back(s2);
+    }
+    for (; i < std::ranges::size(b); ++i) {
+      D s = b[i] + cy;
+      cy = s < b[i];
+      r.digits.push_back(s);
+    }
+    if (cy > 0) {
+      r.digits.push_back(1u);
+    }
+  }
+  return r;
+}
+
+template <container C>
+constexpr z<C> sub_n(const z<C>& lhs, const z<C>& rhs) {
+  assert(std::ranges::size(lhs.digits) >= std::ranges::size(rhs.digits));
+  using D = typename z<C>::digit_type;
+  z<C> r;
+  const auto& a = lhs.digits;
+  const auto& b = rhs.digits;
+
+  if constexpr (std::ranges::contiguous_range<C>) {
+    r.digits.resize(std::ranges::size(a));
+    [[maybe_unused]] D borrow =
+        details::sub_limbs<D>(std::span<D>(std::ranges::data(r.digits), std::ranges::size(a)), a, b);
+    assert(borrow == 0);
+  } else {
+    r.digits.reserve(a.size());
+    D borrow = 0;
+    size_t i = 0;
+
+    for (; i < b.size(); ++i) {
+      D d1 = a[i];
+      D d2 = b[i];
+      D diff = d1 - d2 - borrow;
+      borrow = borrow ? (d1 <= d2) : (d1 < d2);
+      r.digits.push_back(diff);
+    }
+    for (; i < a.size(); ++i) {
+      D d1 = a[i];
+      D diff = d1 - borrow;
+      borrow = (d1 < borrow);
+      r.digits.push_back(diff);
+    }
+    assert(borrow == 0);
+  }
+  normalize(r);
+  return r;
+}
+
+namespace details {
+
+// r = |lhs| * |rhs|, reusing the digit storage of r, which must not be an operand. Aliased operands
+// take the squaring path.
+template <container C>
+constexpr z<C>& mul_n_to(z<C>& r, const z<C>& lhs, const z<C>& rhs) {
+  using D = typename z<C>::digit_type;
+  assert(&r != &lhs && &r != &rhs);
+  r.sgn = sign::positive;
+  if (is_zero(lhs) || is_zero(rhs)) {
+    r.digits.clear();
+    return r;
+  }
+
+  const auto an = std::ranges::size(lhs.digits);
+  const auto bn = std::ranges::size(rhs.digits);
+  const bool square = &lhs == &rhs;
+  const scratch_buffer<D> ws(mul_limbs_scratch<D>(std::max(an, bn), std::min(an, bn)));
+
+  r.digits.resize(an + bn);
+  if constexpr (std::ranges::contiguous_range<C>) {
+    std::span<D> p{std::ranges::data(r.digits), an + bn};
+    std::span<const D> a{std::ranges::data(lhs.digits), an};
+    if (square) {
+      sqr_limbs<D>(p, a, ws);
+    } else {
+      mul_limbs<D>(p, a, std::span<const D>{std::ranges::data(rhs.digits), bn}, ws);
+    }
+  } else {
+    const scratch_buffer<D> a(an), b(square ? 0 : bn), p(an + bn);
+    std::ranges::copy(lhs.digits, a.span().begin());
+    if (square) {
+      sqr_limbs<D>(p, a, ws);
+    } else {
+      std::ranges::copy(rhs.digits, b.span().begin());
+      mul_limbs<D>(p, a, b, ws);
+    }
+    std::ranges::copy(p.span(), std::ranges::begin(r.digits));
+  }
+  return normalize(r);
+}
+
+}  // namespace details
+
+template <container C>
+constexpr z<C> sqr_n(const z<C>& num) {
+  z<C> r;
+  details::mul_n_to(r, num, num);
+  return r;
+}
+
+template <container C>
+constexpr z<C> mul_n(const z<C>& lhs, const z<C>& rhs) {
+  z<C> r;
+  details::mul_n_to(r, lhs, rhs);
+  return r;
+}
+
+// Preallocates the scratch stack of the calling thread for a product of an an- by a bn-digit z<C>,
+// or the schoolbook division of one by the other, so that these take no scratch from the heap. The
+// Toom and transform tiers multiply their pieces through mul_n, one level of scratch on top of the
+// other; the stack grows to hold those after the first such product. See details::scratch_stack
+// for how much of it a thread keeps.
+template <container C>
+void reserve_scratch(size_t an, size_t bn) {
+  using D = typename z<C>::digit_type;
+  using details::scratch_stack;
+  auto bytes = [](size_t digits) { return scratch_stack::block_size(digits * sizeof(D)); };
+  if (an < bn) {
+    std::swap(an, bn);
+  }
+  // mul_n_to and div_knuth also copy the operands and the result of non-contiguous containers
+  constexpr bool copies = !std::ranges::contiguous_range<C>;
+  const size_t mul =
+      bytes(details::mul_limbs_scratch<D>(an, bn)) + (copies ? bytes(an) + bytes(bn) + bytes(an + bn) : 0);
+  const size_t div = bytes(an + 1) + bytes(bn) + (copies ? bytes(an - bn + 1) : 0);
+  scratch_stack::local().reserve(std::max(mul, div));
+}
+
+template <container C>
+constexpr auto div_n(const z<C>& u, typename z<C>::digit_type v) {
+  using D = typename z<C>::digit_type;
+  static_assert(sizeof(D) <= sizeof(max_digit_type));
+
+  struct {
+    z<C> q;
+    D r;
+  } res{};
+
+  res.r = details::div_1(res.q, u, v);
+  normalize(res.q);
+  return res;
+}
+
+// |lhs| / |rhs|. The recursive divisions work on copies of the operands; the schoolbook one reads
+// them in place.
+template <container C>
+constexpr auto div_n(const z<C>& lhs, const z<C>& rhs) {
+  struct result_t {
+    z<C> q;
+    z<C> r;
+  };
+
+  if (is_zero(rhs)) [[unlikely]] {
+    throw divide_by_zero_error{};
+  }
+
+  const auto n = std::ranges::size(rhs.digits);
+  const auto un = std::ranges::size(lhs.digits);
+  if (n >= newton_threshold<global_config_tag> && un >= n + newton_threshold<global_config_tag>) {
+    auto [q, r] = details::div_newton(lhs, rhs);
+    return result_t{.q = std::move(q), .r = std::move(r)};
+  }
+  constexpr auto bz = 2 * bz_threshold<global_config_tag>;
+  if (n >= bz && un >= n + bz) {
+    auto [q, r] = details::div_bz(lhs, rhs);
+    return result_t{.q = std::move(q), .r = std::move(r)};
+  }
+  auto [q, r] = details::div_basecase(lhs, rhs);
+  return result_t{.q = std::move(q), .r = std::move(r)};
+}
+
+template <container C>
+constexpr z<C> add(const z<C>& lhs, const z<C>& rhs) {
+  z<C> r;
+  if (lhs.sgn == rhs.sgn) {
+    r = add_n(lhs, rhs);
+    r.sgn = lhs.sgn;
+  } else {
+    const auto* minuend = &lhs;
+    const auto* substrahend = &rhs;
+    if (cmp_n(lhs, rhs) < 0) {
+      minuend = &rhs;
+      substrahend = &lhs;
+    }
+    r = sub_n(*minuend, *substrahend);
+    r.sgn = std::ranges::size(r.digits) > 0 ? minuend->sgn : sign::positive;
+  }
+  return r;
+}
+
+template <container C>
+constexpr z<C> sub(const z<C>& lhs, z<C> rhs) {
+  return add(lhs, negate(rhs));
+}
+
+template <container C>
+constexpr z<C> mul(const z<C>& lhs, const z<C>& rhs) {
+  z<C> r = mul_n(lhs, rhs);
+  if (is_zero(r)) {
+    return r;
+  }
+  r.sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  return r;
+}
+
+template <container C>
+constexpr z<C> sqr(const z<C>& num) {
+  return sqr_n(num);
+}
+
+template <container C>
+constexpr auto div(z<C> lhs, z<C> rhs) {
+  struct result_t {
+    z<C> q;
+    z<C> r;
+  };
+  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  auto [q, r] = div_n(lhs, rhs);
+  result_t res = {.q = std::move(q), .r = std::move(r)};
+
+  res.r.sgn = lhs.sgn;
+  res.q.sgn = sgn;
+  return res;
+}
+
+template <container C>
+constexpr auto floor_div(z<C> lhs, z<C> rhs) {
+  struct result_t {
+    z<C> q;
+    z<C> r;
+  };
+
+  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  auto [q, r] = div_n(lhs, rhs);
+  result_t res = {.q = std::move(q), .r = std::move(r)};
+
+  if (sgn == sign::negative && !is_zero(res.r)) {
+    res.q = add_n(res.q, details::one<C>());
+    res.r = sub_n(rhs, res.r);
+  }
+
+  res.q.sgn = sgn;
+  res.r.sgn = rhs.sgn;
+  return res;
+}
+
+template <container C>
+constexpr auto ceil_div(z<C> lhs, z<C> rhs) {
+  struct result_t {
+    z<C> q;
+    z<C> r;
+  };
+
+  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  auto [q, r] = div_n(lhs, rhs);
+  result_t res = {.q = std::move(q), .r = std::move(r)};
+
+  if (sgn == sign::positive && !is_zero(res.r)) {
+    res.q = add_n(res.q, details::one<C>());
+    res.r = sub_n(rhs, res.r);
+  }
+  res.q.sgn = sgn;
+  res.r.sgn = rhs.sgn == sign::positive ? sign::negative : sign::positive;
+  return res;
+}
+
+namespace details {
+
+// dst = lhs + (rsgn)|rhs|, reusing the digit storage of dst, which may be an operand.
+template <container C>
+constexpr z<C>& add_signed_to(z<C>& dst, const z<C>& lhs, const z<C>& rhs, sign rsgn) {
+  using D = typename z<C>::digit_type;
+  if constexpr (!std::ranges::contiguous_range<C>) {
+    auto b = rhs;
+    b.sgn = rsgn;
+    return dst = add(lhs, b);
+  } else {
+    const auto lsgn = lhs.sgn;
+    if (lsgn == rsgn) {
+      const auto* a = &lhs;
+      const auto* b = &rhs;
+      if (std::ranges::size(a->digits) < std::ranges::size(b->digits)) std::swap(a, b);
+      const auto an = std::ranges::size(a->digits), bn = std::ranges::size(b->digits);
+      dst.digits.resize(an + 1);  // keeps the digits of an aliased operand
+      D* r = std::ranges::data(dst.digits);
+      r[an] = add_limbs<D>(std::span{r, an}, std::span{std::ranges::data(a->digits), an},
+                           std::span{std::ranges::data(b->digits), bn});
+      dst.sgn = lsgn;
+    } else {
+      const int rel = cmp_n(lhs, rhs);
+      if (rel == 0) {
+        dst.digits.clear();
+        dst.sgn = sign::positive;
+        return dst;
+      }
+      const auto* a = rel > 0 ? &lhs : &rhs;
+      const auto* b = rel > 0 ? &rhs : &lhs;
+      const auto an = std::ranges::size(a->digits), bn = std::ranges::size(b->digits);
+      dst.digits.resize(an);
+      D* r = std::ranges::data(dst.digits);
+      sub_limbs<D>(std::span{r, an}, std::span{std::ranges::data(a->digits), an},
+                   std::span{std::ranges::data(b->digits), bn});
+      dst.sgn = rel > 0 ? lsgn : rsgn;
+    }
+    return normalize(dst);
+  }
+}
+
+// dst += (psgn)|lhs * rhs|. The product goes into scratch and is then added in place, so the digit
+// storage of dst, which may be an operand, is reused.
+template <container C>
+constexpr z<C>& addmul_signed(z<C>& dst, const z<C>& lhs, const z<C>& rhs, sign psgn) {
+  using D = typename z<C>::digit_type;
+  if constexpr (!std::ranges::contiguous_range<C>) {
+    z<C> p;
+    mul_n_to(p, lhs, rhs);
+    return add_signed_to(dst, dst, p, psgn);
+  } else {
+    if (is_zero(lhs) || is_zero(rhs)) return dst;
+    const auto an = std::ranges::size(lhs.digits), bn = std::ranges::size(rhs.digits);
+    const scratch_buffer<D> pb(an + bn);
+    const scratch_buffer<D> ws(mul_limbs_scratch<D>(std::max(an, bn), std::min(an, bn)));
+    const std::span<const D> a{std::ranges::data(lhs.digits), an};
+    if (&lhs == &rhs) {
+      sqr_limbs<D>(pb, a, ws);
+    } else {
+      mul_limbs<D>(pb, a, std::span<const D>{std::ranges::data(rhs.digits), bn}, ws);
+    }
+    const auto p = pb.span().first(pb.span().back() == 0 ? an + bn - 1 : an + bn);
+
+    if (is_zero(dst)) dst.sgn = psgn;
+    const auto n = std::max(std::ranges::size(dst.digits), p.size());
+    if (dst.sgn == psgn) {
+      dst.digits.resize(n + 1);
+      const std::span<D> d{std::ranges::data(dst.digits), n};
+      dst.digits[n] = add_limbs<D>(d, d, p);
+    } else {
+      dst.digits.resize(n);
+      const std::span<D> d{std::ranges::data(dst.digits), n};
+      if (cmp_limbs<D>(d, p) >= 0) {
+        sub_limbs<D>(d, d, p);
+      } else {
+        // |dst| < |p| implies |dst| <= |p| == n
+        sub_limbs<D>(d, p, d);
+        dst.sgn = psgn;
+      }
+    }
+    return normalize(dst);
+  }
+}
+
+// Turns the truncated |lhs| / |d| = q, r into floor_div's, for a quotient of sign sgn: q = |q| + 1
+// and r = |d| - |r| when the quotient is negative and inexact, then q takes sgn and r the sign of d.
+// Works in the storage of q and r, neither of which may be d.
+template <container C>
+constexpr void floor_adjust(z<C>& q, z<C>& r, const z<C>& d, sign sgn) {
+  using D = typename z<C>::digit_type;
+  if (sgn == sign::negative && !is_zero(r)) {
+    if constexpr (std::ranges::contiguous_range<C>) {
+      const D one = 1;
+      const auto qn = std::ranges::size(q.digits);
+      const auto n = std::ranges::size(d.digits);
+      q.digits.resize(qn + 1);
+      const std::span<D> qd{std::ranges::data(q.digits), qn + 1};
+      add_limbs<D>(qd, qd, std::span<const D>{&one, 1});
+      r.digits.resize(n);
+      const std::span<D> rd{std::ranges::data(r.digits), n};
+      sub_limbs<D>(rd, std::span<const D>{std::ranges::data(d.digits), n}, rd);
+    } else {
+      q = add_n(q, one<C>());
+      r = sub_n(d, r);
+    }
+  }
+  q.sgn = sgn;
+  r.sgn = d.sgn;
+  normalize(q);
+  normalize(r);
+}
+
+// q = floor((usgn)|u| / v) for a digit v > 0; returns the remainder, in [0, v). q may be u.
+template <container C>
+constexpr typename z<C>::digit_type floor_div_1(z<C>& q, const z<C>& u, typename z<C>::digit_type v, sign usgn) {
+  auto rem = div_1(q, u, v);
+  q.sgn = usgn;
+  normalize(q);
+  if (usgn == sign::negative && rem != 0) {
+    // round the magnitude of the quotient up
+    const auto qn = std::ranges::size(q.digits);
+    auto i = 0uz;
+    while (i < qn && ++q.digits[i] == 0) ++i;
+    if (i == qn) q.digits.push_back(1u);
+    q.sgn = sign::negative;
+    rem = v - rem;
+  }
+  return rem;
+}
+
+// r = |a| * v, with the sign of r left as it was. r may be a.
+template <container C>
+constexpr z<C>& mul_1(z<C>& r, const z<C>& a, typename z<C>::digit_type v) {
+  using D = typename z<C>::digit_type;
+  const auto n = std::ranges::size(a.digits);
+  if (&r != &a) r.digits.resize(n);
+  D cy = 0;
+  for (auto i = 0uz; i < n; ++i) {
+    auto [p0, p1] = umul(a.digits[i], v);
+    p0 += cy;
+    cy = p1 + (p0 < cy ? 1u : 0u);
+    r.digits[i] = p0;
+  }
+  if (cy != 0) r.digits.push_back(cy);
+  return r;
+}
+
+// dst += (s)|a| * v in a single pass over the digits. When the subtraction crosses zero the
+// digits hold the B-complement of the result, which is negated in place.
+template <container C>
+constexpr z<C>& addmul_1(z<C>& dst, const z<C>& a, typename z<C>::digit_type v, sign s) {
+  using D = typename z<C>::digit_type;
+  if (&dst == &a) {
+    const z<C> t = a;
+    return addmul_1(dst, t, v, s);
+  }
+  if (is_zero(dst)) dst.sgn = s;
+  const auto n = std::ranges::size(a.digits);
+  const auto m = std::max(std::ranges::size(dst.digits), n);
+  dst.digits.resize(m + 1);
+  D cy = 0;
+  if (dst.sgn == s) {
+    for (auto i = 0uz; i < n; ++i) {
+      auto [p0, p1] = umul(a.digits[i], v);
+      p0 += cy;
+      p1 += p0 < cy ? 1u : 0u;
+      const D d = dst.digits[i] + p0;
+      cy = p1 + (d < p0 ? 1u : 0u);
+      dst.digits[i] = d;
+    }
+    for (auto i = n; cy != 0 && i <= m; ++i) {
+      const D d = dst.digits[i] + cy;
+      cy = d < cy ? 1u : 0u;
+      dst.digits[i] = d;
+    }
+  } else {
+    for (auto i = 0uz; i < n; ++i) {
+      auto [p0, p1] = umul(a.digits[i], v);
+      p0 += cy;
+      p1 += p0 < cy ? 1u : 0u;
+      const D d = dst.digits[i];
+      cy = p1 + (d < p0 ? 1u : 0u);
+      dst.digits[i] = d - p0;
+    }
+    for (auto i = n; cy != 0 && i <= m; ++i) {
+      const D d = dst.digits[i];
+      dst.digits[i] = d - cy;
+      cy = d < cy ? 1u : 0u;
+    }
+    if (cy != 0) {
+      D c = 1;
+      for (auto i = 0uz; i <= m; ++i) {
+        const D d = static_cast<D>(~dst.digits[i] + c);
+        c = d < c ? 1u : 0u;
+        dst.digits[i] = d;
+      }
+      dst.sgn = s;
+    }
+  }
+  return normalize(dst);
+}
+
+template <std::signed_integral S>
+constexpr std::make_unsigned_t<S> uabs(S v) noexcept {
+  using U = std::make_unsigned_t<S>;
+  return v < 0 ? static_cast<U>(U{0} - static_cast<U>(v)) : static_cast<U>(v);
+}
+
+// |v| as a word; v must fit in U.
+template <std::unsigned_integral U, container C>
+constexpr U to_word(const z<C>& v) {
+  using D = typename z<C>::digit_type;
+  static_assert(sizeof(U) > sizeof(D));
+  U w = 0;
+  for (auto i = std::ranges::size(v.digits); i > 0; --i) {
+    w = static_cast<U>((w << (sizeof(D) * CHAR_BIT)) | v.digits[i - 1]);
+  }
+  return w;
+}
+
+}  // namespace details
+
+// Destination-passing forms of the arithmetic above, for loops that would otherwise allocate a
+// fresh z per operation. Each writes its result to dst and reuses dst's digit storage; dst may be
+// one of the operands.
+
+// dst = lhs + rhs
+template <container C>
+constexpr z<C>& add_to(z<C>& dst, const z<C>& lhs, const z<C>& rhs) {
+  return details::add_signed_to(dst, lhs, rhs, rhs.sgn);
+}
+
+// dst = lhs - rhs
+template <container C>
+constexpr z<C>& sub_to(z<C>& dst, const z<C>& lhs, const z<C>& rhs) {
+  return details::add_signed_to(dst, lhs, rhs, rhs.sgn == sign::positive ? sign::negative : sign::positive);
+}
+
+// dst = lhs * rhs
+template <container C>
+constexpr z<C>& mul_into(z<C>& dst, const z<C>& lhs, const z<C>& rhs) {
+  const auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  if (&dst == &lhs || &dst == &rhs) {
+    z<C> r;
+    details::mul_n_to(r, lhs, rhs);
+    dst = std::move(r);
+  } else {
+    details::mul_n_to(dst, lhs, rhs);
+  }
+  if (!is_zero(dst)) dst.sgn = sgn;
+  return dst;
+}
+
+namespace details {
+
+// dst = lhs * rhs / 2^bits, rounded toward zero or one unit short of it in magnitude. A short
+// product leaves out the partial products too low to reach bit bits. dst must not be an operand.
+template <container C>
+constexpr z<C>& mul_high_into(z<C>& dst, const z<C>& lhs, const z<C>& rhs, int bits) {
+  using D = typename z<C>::digit_type;
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  assert(&dst != &lhs && &dst != &rhs);
+  const auto an = std::ranges::size(lhs.digits);
+  const auto bn = std::ranges::size(rhs.digits);
+  // what is left out, below min(an, bn) * B^(t + 1), must stay below 2^bits
+  const int t = (bits - std::bit_width(std::min(an, bn))) / dbits - 1;
+  if (t <= 0 || is_zero(lhs) || is_zero(rhs)) {
+    mul_into(dst, lhs, rhs);
+    return mul_2exp(dst, -bits);
+  }
+
+  const auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  const bool square = &lhs == &rhs;
+  const scratch_buffer<D> ws(mul_high_scratch<D>(an, bn, static_cast<size_t>(t)));
+  dst.digits.resize(an + bn);
+  if constexpr (std::ranges::contiguous_range<C>) {
+    std::span<const D> a{std::ranges::data(lhs.digits), an};
+    mul_high_limbs<D>(std::span<D>{std::ranges::data(dst.digits), an + bn}, a,
+                      square ? a : std::span<const D>{std::ranges::data(rhs.digits), bn}, static_cast<size_t>(t), ws);
+  } else {
+    const scratch_buffer<D> a(an), b(square ? 0 : bn), p(an + bn);
+    std::ranges::copy(lhs.digits, a.span().begin());
+    if (square) {
+      mul_high_limbs<D>(p, a, a, static_cast<size_t>(t), ws);
+    } else {
+      std::ranges::copy(rhs.digits, b.span().begin());
+      mul_high_limbs<D>(p, a, b, static_cast<size_t>(t), ws);
+    }
+    std::ranges::copy(p.span(), std::ranges::begin(dst.digits));
+  }
+  dst.sgn = sign::positive;
+  mul_2exp(normalize(dst), -bits);
+  if (!is_zero(dst)) dst.sgn = sgn;
+  return dst;
+}
+
+}  // namespace details
+
+// dst += lhs * rhs
+template <container C>
+constexpr z<C>& addmul(z<C>& dst, const z<C>& lhs, const z<C>& rhs) {
+  return details::addmul_signed(dst, lhs, rhs, lhs.sgn == rhs.sgn ? sign::positive : sign::negative);
+}
+
+// dst -= lhs * rhs
+template <container C>
+constexpr z<C>& submul(z<C>& dst, const z<C>& lhs, const z<C>& rhs) {
+  return details::addmul_signed(dst, lhs, rhs, lhs.sgn == rhs.sgn ? sign::negative : sign::positive);
+}
+
+// q, r = floor_div(lhs, rhs). q and r must be distinct, but either may be an operand. A single-digit
+// divisor, and a schoolbook division when neither q nor r is rhs, reuse the storage of q and r; the
+// subquadratic divisions move their results into q and r.
+template <container C>
+constexpr void floor_div_into(z<C>& q, z<C>& r, const z<C>& lhs, const z<C>& rhs) {
+  using D = typename z<C>::digit_type;
+  assert(&q != &r);
+  if (is_zero(rhs)) [[unlikely]] {
+    throw divide_by_zero_error{};
+  }
+
+  const auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
+  const auto rsgn = rhs.sgn;
+  const auto n = std::ranges::size(rhs.digits);
+  if (n == 1) {
+    const D rem = details::floor_div_1(q, lhs, rhs.digits[0], sgn);
+    r.digits.clear();
+    if (rem != 0) r.digits.push_back(rem);
+    r.sgn = rem != 0 ? rsgn : sign::positive;
+    return;
+  }
+
+  if constexpr (std::ranges::contiguous_range<C>) {
+    const auto un = std::ranges::size(lhs.digits);
+    constexpr auto bz = 2 * bz_threshold<global_config_tag>;
+    const bool newton = n >= newton_threshold<global_config_tag> && un >= n + newton_threshold<global_config_tag>;
+    if (&q != &rhs && &r != &rhs && !newton && !(n >= bz && un >= n + bz)) {
+      details::div_basecase_to(q, r, lhs, rhs);
+      details::floor_adjust(q, r, rhs, sgn);
+      return;
+    }
+  }
+
+  // only the results are moved, once rhs has been used
+  auto [qq, rr] = div_n(lhs, rhs);
+  details::floor_adjust(qq, rr, rhs, sgn);
+  q = std::move(qq);
+  r = std::move(rr);
+}
+
+// Arithmetic with a machine-word operand, for series loops that would otherwise build a z for a
+// small multiplier or divisor. A word that fits in one digit takes a single pass over the digits;
+// wider words go through the general kernels. The destination may be the z operand.
+
+// dst = src * v
+template <container C, std::unsigned_integral U>
+constexpr z<C>& mul_ui(z<C>& dst, const z<C>& src, U v) {
+  using D = typename z<C>::digit_type;
+  if constexpr (sizeof(U) > sizeof(D)) {
+    if (v > std::numeric_limits<D>::max()) return mul_into(dst, src, create<C>(v));
+  }
+  const auto sgn = src.sgn;
+  details::mul_1(dst, src, static_cast<D>(v));
+  dst.sgn = sgn;
+  return normalize(dst);
+}
+
+// dst = src * v
+template <container C, std::signed_integral S>
+constexpr z<C>& mul_si(z<C>& dst, const z<C>& src, S v) {
+  mul_ui(dst, src, details::uabs(v));
+  return v < 0 ? negate(dst) : dst;
+}
+
+// dst += src * v
+template <container C, std::unsigned_integral U>
+constexpr z<C>& addmul_ui(z<C>& dst, const z<C>& src, U v) {
+  using D = typename z<C>::digit_type;
+  if constexpr (sizeof(U) > sizeof(D)) {
+    if (v > std::numeric_limits<D>::max()) return addmul(dst, src, create<C>(v));
+  }
+  return details::addmul_1(dst, src, static_cast<D>(v), src.sgn);
+}
+
+// dst -= src * v
+template <container C, std::unsigned_integral U>
+constexpr z<C>& submul_ui(z<C>& dst, const z<C>& src, U v) {
+  using D = typename z<C>::digit_type;
+  if constexpr (sizeof(U) > sizeof(D)) {
+    if (v > std::numeric_limits<D>::max()) return submul(dst, src, create<C>(v));
+  }
+  return details::addmul_1(dst, src, static_cast<D>(v), is_negative(src) ? sign::positive : sign::negative);
+}
+
+// q = src / v rounded toward zero; returns |src| mod v, as mpz_tdiv_q_ui does.
+template <container C, std::unsigned_integral U>
+constexpr U div_ui(z<C>& q, const z<C>& src, U v) {
+  using D = typename z<C>::digit_type;
+  if (v == 0) [[unlikely]] {
+    throw divide_by_zero_error{};
+  }
+  if constexpr (sizeof(U) > sizeof(D)) {
+    if (v > std::numeric_limits<D>::max()) {
+      auto [qq, rr] = div(src, create<C>(v));
+      q = std::move(normalize(qq));
+      return details::to_word<U>(rr);
+    }
+  }
+  const auto sgn = src.sgn;
+  const D rem = details::floor_div_1(q, src, static_cast<D>(v), sign::positive);
+  q.sgn = sgn;
+  normalize(q);
+  return static_cast<U>(rem);
+}
+
+// q = floor(src / v); returns the remainder src - q * v, in [0, v).
+template <container C, std::unsigned_integral U>
+constexpr U floor_div_ui(z<C>& q, const z<C>& src, U v) {
+  using D = typename z<C>::digit_type;
+  if (v == 0) [[unlikely]] {
+    throw divide_by_zero_error{};
+  }
+  if constexpr (sizeof(U) > sizeof(D)) {
+    if (v > std::numeric_limits<D>::max()) {
+      z<C> r;
+      floor_div_into(q, r, src, create<C>(v));
+      return details::to_word<U>(r);
+    }
+  }
+  return static_cast<U>(details::floor_div_1(q, src, static_cast<D>(v), src.sgn));
+}
+
+// q = floor(src / v); returns the remainder src - q * v, which has the sign of v.
+template <container C, std::signed_integral S>
+constexpr S floor_div_si(z<C>& q, const z<C>& src, S v) {
+  using D = typename z<C>::digit_type;
+  if (v == 0) [[unlikely]] {
+    throw divide_by_zero_error{};
+  }
+  const auto uv = details::uabs(v);
+  if constexpr (sizeof(S) > sizeof(D)) {
+    if (uv > std::numeric_limits<D>::max()) {
+      z<C> r;
+      floor_div_into(q, r, src, create<C>(v));
+      const auto w = static_cast<S>(details::to_word<std::make_unsigned_t<S>>(r));
+      return is_negative(r) ? static_cast<S>(-w) : w;
+    }
+  }
+  // floor(src / v) = floor(-src / |v|) for v < 0, with the remainder negated
+  const auto usgn = (v < 0) == is_negative(src) ? sign::positive : sign::negative;
+  const auto rem = static_cast<S>(details::floor_div_1(q, src, static_cast<D>(uv), usgn));
+  return v < 0 ? static_cast<S>(-rem) : rem;
+}
+
+namespace details {
+
+// dst = src * 2^exp, the magnitude rounded toward zero for exp < 0. Each digit of dst is built from
+// two digits of src in one pass, towards the top for exp > 0 and towards the bottom otherwise, so
+// dst may be src; the digit storage of dst is resized once.
 template <container C>
-constexpr z<C> mul(const z<C>& lhs, const z<C>& rhs) {
-  z<C> r = mul_n(lhs, rhs);
-  if (is_zero(r)) {
-    return r;
+constexpr z<C>& mul_2exp_to(z<C>& dst, const z<C>& src, int exp) {
+  using D = typename z<C>::digit_type;
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  const auto n = std::ranges::size(src.digits);
+  const auto sgn = src.sgn;
+  auto& r = dst.digits;
+  const auto& a = src.digits;
+  if (exp >= 0) {
+    const auto k = static_cast<size_t>(exp / dbits);
+    const int s = exp % dbits;
+    const D top = s > 0 && n > 0 ? static_cast<D>(a[n - 1] >> (dbits - s)) : D{0};
+    r.resize(n == 0 ? 0 : n + k + (top != 0));
+    if (n == 0) return dst;
+    if (top != 0) r[n + k] = top;
+    if (s == 0) {
+      for (size_t i = n; i-- > 0;) r[i + k] = a[i];
+    } else {
+      for (size_t i = n - 1; i > 0; --i) {
+        r[i + k] = static_cast<D>(static_cast<D>(a[i] << s) | (a[i - 1] >> (dbits - s)));
+      }
+      r[k] = static_cast<D>(a[0] << s);
+    }
+    std::fill_n(std::ranges::begin(r), k, D{0});
+  } else {
+    const auto k = static_cast<size_t>(-(exp / dbits));
+    const int s = -(exp % dbits);
+    const size_t m = k < n ? n - k : 0;
+    if (&dst != &src) r.resize(m);
+    if (m > 0 && s == 0) {
+      for (size_t i = 0; i < m; ++i) r[i] = a[i + k];
+    } else if (m > 0) {
+      for (size_t i = 0; i + 1 < m; ++i) {
+        r[i] = static_cast<D>((a[i + k] >> s) | static_cast<D>(a[i + k + 1] << (dbits - s)));
+      }
+      r[m - 1] = static_cast<D>(a[n - 1] >> s);
+    }
+    r.resize(m);
   }
-  r.sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
-  return r;
+  dst.sgn = sgn;
+  return normalize(dst);
 }
 
+}  // namespace details
+
 template <container C>
-constexpr auto div(z<C> lhs, z<C> rhs) {
-  struct result_t {
-    z<C> q;
-    z<C> r;
-  };
-  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
-  auto [q, r] = div_n(std::move(lhs), std::move(rhs));
-  result_t res = {.q = std::move(q), .r = std::move(r)};
+constexpr z<C>& mul_2exp(z<C>& val, int exp) {
+  if (exp == 0) {
+    return val;
+  }
+  return details::mul_2exp_to(val, val, exp);
+}
 
-  res.r.sgn = lhs.sgn;
-  res.q.sgn = sgn;
+template <container C>
+constexpr z<C>& mul_4exp(z<C>& val, int exp) {
+  return mul_2exp(val, 2 * exp);
+}
+
+template <container C>
+constexpr z<C> mul_2exp(const z<C>& val, int exp) {
+  z<C> res;
+  details::mul_2exp_to(res, val, exp);
   return res;
 }
 
 template <container C>
-constexpr auto floor_div(z<C> lhs, z<C> rhs) {
+constexpr z<C> mul_4exp(const z<C>& val, int exp) {
+  return mul_2exp(val, 2 * exp);
+}
+
+// A divisor prepared for repeated division. The normalization shift and the reciprocal of the top
+// digit are computed once, and from barrett_threshold digits on so is a Barrett reciprocal of the
+// whole divisor; a power of two divides by shifting. Worth it from the second division on.
+template <container C>
+class divisor {
+ public:
+  using digit_type = typename z<C>::digit_type;
+
+  constexpr explicit divisor(z<C> d) : d_(std::move(d)) {
+    if (is_zero(d_)) [[unlikely]] {
+      throw divide_by_zero_error{};
+    }
+    const auto n = std::ranges::size(d_.digits);
+    const auto top = d_.digits[n - 1];
+    s_ = std::countl_zero(top);
+    pow2_ = std::has_single_bit(top) &&
+            std::all_of(std::ranges::begin(d_.digits), std::ranges::begin(d_.digits) + (n - 1),
+                        [](digit_type v) { return v == 0; });
+    dn_.digits = d_.digits;
+    details::bit_shift(dn_.digits, s_);
+    vinv_ = details::reciprocal_1(dn_.digits[n - 1]);
+    if (!pow2_ && n >= barrett_threshold<global_config_tag>) {
+      x_ = details::reciprocal(dn_, n);
+    }
+  }
+
+  constexpr const z<C>& value() const noexcept { return d_; }
+
+  // |lhs| / |d|, with a nonnegative quotient and remainder.
+  friend constexpr details::div_result<C> div_n(const z<C>& lhs, const divisor& d) {
+    constexpr int dbits = static_cast<int>(sizeof(digit_type) * CHAR_BIT);
+    const auto n = std::ranges::size(d.d_.digits);
+    const auto un = std::ranges::size(lhs.digits);
+    details::div_result<C> res;
+    if (cmp_n(lhs, d.d_) < 0) {
+      res.r.digits = lhs.digits;
+      return res;
+    }
+    if (d.pow2_) {
+      const auto bits = static_cast<int>((n - 1) * dbits) + (dbits - 1 - d.s_);
+      res.q.digits = lhs.digits;
+      mul_2exp(res.q, -bits);
+      res.r = details::low_bits(lhs, static_cast<size_t>(bits));
+      return res;
+    }
+    if (n == 1) {
+      digit_type rem;
+      if constexpr (sizeof(digit_type) < sizeof(uint32_t)) {
+        rem = details::div_1(res.q, lhs, d.d_.digits[0]);
+      } else {
+        rem = details::div_1_norm(res.q, lhs, d.dn_.digits[0], d.vinv_, d.s_);
+      }
+      res.q.sgn = sign::positive;
+      normalize(res.q);
+      if (rem != 0) res.r.digits.push_back(rem);
+      return res;
+    }
+    if (!is_zero(d.x_) && un >= 2 * n) {
+      z<C> u{.digits = lhs.digits};
+      mul_2exp(u, d.s_);
+      res = details::div_barrett(u, d.dn_, d.x_);
+      mul_2exp(res.r, -d.s_);
+      return res;
+    }
+    constexpr auto bz = 2 * bz_threshold<global_config_tag>;
+    if (n >= bz && un >= n + bz) {
+      auto [q, r] = epx::div_n(lhs, d.d_);
+      res.q = std::move(q);
+      res.r = std::move(r);
+      return res;
+    }
+    if constexpr (std::ranges::contiguous_range<C>) {
+      return details::div_knuth(lhs, std::span<const digit_type>{std::ranges::data(d.dn_.digits), n}, d.s_, d.vinv_);
+    } else {
+      const details::scratch_buffer<digit_type> v(n);
+      std::ranges::copy(d.dn_.digits, v.span().begin());
+      return details::div_knuth(lhs, v, d.s_, d.vinv_);
+    }
+  }
+
+ private:
+  z<C> d_;
+  z<C> dn_;  // |d| << s_
+  z<C> x_;   // reciprocal(dn_), or zero below barrett_threshold
+  int s_ = 0;
+  digit_type vinv_ = 0;
+  bool pow2_ = false;
+};
+
+template <container C>
+constexpr auto floor_div(const z<C>& lhs, const divisor<C>& rhs) {
   struct result_t {
     z<C> q;
     z<C> r;
   };
 
-  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
-  auto [q, r] = div_n(std::move(lhs), rhs);
+  const auto& d = rhs.value();
+  auto sgn = lhs.sgn == d.sgn ? sign::positive : sign::negative;
+  auto [q, r] = div_n(lhs, rhs);
   result_t res = {.q = std::move(q), .r = std::move(r)};
 
   if (sgn == sign::negative && !is_zero(res.r)) {
     res.q = add_n(res.q, details::one<C>());
-    res.r = sub_n(rhs, res.r);
+    res.r = sub_n(d, res.r);
   }
 
-  res.q.sgn = sgn;
-  res.r.sgn = rhs.sgn;
+  res.q.sgn = is_zero(res.q) ? sign::positive : sgn;
+  res.r.sgn = is_zero(res.r) ? sign::positive : d.sgn;
   return res;
 }
 
+// q, r = floor_div(lhs, rhs), moved into q and r. q and r must be distinct, but either may be lhs.
 template <container C>
-constexpr auto ceil_div(z<C> lhs, z<C> rhs) {
-  struct result_t {
-    z<C> q;
-    z<C> r;
-  };
+constexpr void floor_div_into(z<C>& q, z<C>& r, const z<C>& lhs, const divisor<C>& rhs) {
+  assert(&q != &r);
+  const auto& d = rhs.value();
+  const auto sgn = lhs.sgn == d.sgn ? sign::positive : sign::negative;
+  auto [qq, rr] = div_n(lhs, rhs);
+  details::floor_adjust(qq, rr, d, sgn);
+  q = std::move(qq);
+  r = std::move(rr);
+}
 
-  auto sgn = lhs.sgn == rhs.sgn ? sign::positive : sign::negative;
-  auto [q, r] = div_n(std::move(lhs), rhs);
-  result_t res = {.q = std::move(q), .r = std::move(r)};
+// A multiplier prepared for repeated products by the same z. Products long enough for the
+// number-theoretic transform reuse the forward transforms of its digits, kept for the last transform
+// length used, so that each takes two transforms per prime instead of three; shorter ones go through
+// mul_into. Updating that cache makes a prepared_multiplier unsafe to share between threads.
+template <container C>
+class prepared_multiplier {
+ public:
+  using digit_type = typename z<C>::digit_type;
 
-  if (sgn == sign::positive && !is_zero(res.r)) {
-    res.q = add_n(res.q, details::one<C>());
-    res.r = sub_n(rhs, res.r);
+  constexpr explicit prepared_multiplier(z<C> v) : v_(std::move(v)) {}
+
+  constexpr const z<C>& value() const noexcept { return v_; }
+
+  // True when a product by lhs takes the transform.
+  constexpr bool transforms(const z<C>& lhs) const noexcept {
+    const auto an = std::ranges::size(lhs.digits), bn = std::ranges::size(v_.digits);
+    return details::select_mul<digit_type>(std::max(an, bn), std::min(an, bn)) == details::mul_algo::ntt;
+  }
+
+  // Forward transforms of value() of length n, computed on first use of n.
+  constexpr const details::ntt::transform& transform(size_t n) const {
+    if (f_.n != n) {
+      const std::vector<digit_type> b(std::ranges::begin(v_.digits), std::ranges::end(v_.digits));
+      f_ = details::ntt::prepare(details::ntt_pack<digit_type>(b), n);
+    }
+    return f_;
   }
-  res.q.sgn = sgn;
-  res.r.sgn = rhs.sgn == sign::positive ? sign::negative : sign::positive;
-  return res;
-}
 
+ private:
+  z<C> v_;
+  mutable details::ntt::transform f_;
+};
+
+// dst = lhs * m.value()
 template <container C>
-constexpr z<C>& mul_2exp(z<C>& val, int exp) {
+constexpr z<C>& mul_into(z<C>& dst, const z<C>& lhs, const prepared_multiplier<C>& m) {
   using D = typename z<C>::digit_type;
-  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
-  if (is_zero(val) || exp == 0) {
-    return val;
+  const auto& v = m.value();
+  if (!m.transforms(lhs)) {
+    return mul_into(dst, lhs, v);
   }
-  if (std::abs(exp) < dbits) {
-    D cy = details::bit_shift(val.digits, exp);
-    if (cy > 0) {
-      val.digits.push_back(cy);
-    }
-    normalize(val);
-  } else if (exp > 0) {
-    size_t digit_shift = exp / dbits;
-    int bit_shift = exp % dbits;
-    if (bit_shift > 0) {
-      D cy = details::bit_shift(val.digits, bit_shift);
-      if (cy > 0) {
-        val.digits.push_back(cy);
-      }
-    }
-    val.digits.insert(val.digits.begin(), digit_shift, 0u);
-  } else if (exp < 0) {
-    size_t digit_shift = (-exp) / dbits;
-    int bit_shift = (-exp) % dbits;
-    if (digit_shift >= std::ranges::size(val.digits)) {
-      val.digits.clear();
-      val.sgn = sign::positive;
-    } else {
-      val.digits.erase(val.digits.begin(), val.digits.begin() + digit_shift);
-      if (bit_shift > 0) {
-        details::bit_shift(val.digits, -bit_shift);
-        normalize(val);
-      }
+  const auto an = std::ranges::size(lhs.digits), bn = std::ranges::size(v.digits);
+  const auto& tb = m.transform(details::ntt::length(details::ntt_size<D>(an), details::ntt_size<D>(bn)));
+  const auto sgn = lhs.sgn == v.sgn ? sign::positive : sign::negative;
+  if constexpr (std::ranges::contiguous_range<C>) {
+    if (&dst != &lhs) {
+      dst.digits.resize(an + bn);
+      details::mul_ntt<D>(std::span<D>{std::ranges::data(dst.digits), an + bn},
+                          std::span<const D>{std::ranges::data(lhs.digits), an}, tb);
+      dst.sgn = sgn;
+      return normalize(dst);
     }
   }
-  return val;
+  // lhs is copied only when its digits are not contiguous, or are about to be overwritten as dst
+  const std::vector<D> a(std::ranges::begin(lhs.digits), std::ranges::end(lhs.digits));
+  dst.digits.resize(an + bn);
+  if constexpr (std::ranges::contiguous_range<C>) {
+    details::mul_ntt<D>(std::span<D>{std::ranges::data(dst.digits), an + bn}, a, tb);
+  } else {
+    std::vector<D> p(an + bn);
+    details::mul_ntt<D>(p, a, tb);
+    std::ranges::copy(p, std::ranges::begin(dst.digits));
+  }
+  dst.sgn = sgn;
+  return normalize(dst);
 }
 
 template <container C>
-constexpr z<C>& mul_4exp(z<C>& val, int exp) {
-  return mul_2exp(val, 2 * exp);
+constexpr z<C> mul(const z<C>& lhs, const prepared_multiplier<C>& m) {
+  z<C> r;
+  return mul_into(r, lhs, m);
 }
 
-template <container C>
-constexpr z<C> mul_2exp(const z<C>& val, int exp) {
-  auto num = val;
-  return mul_2exp(num, exp);
-}
+namespace details {
 
+// dst = lhs * m.value() / 2^bits, as mul_high_into. Once the full product of the top digits in the
+// short product would take the transform, the whole product is computed with the prepared one.
 template <container C>
-constexpr z<C> mul_4exp(const z<C>& val, int exp) {
-  auto num = val;
-  return mul_4exp(num, exp);
+constexpr z<C>& mul_high_into(z<C>& dst, const z<C>& lhs, const prepared_multiplier<C>& m, int bits) {
+  using D = typename z<C>::digit_type;
+  const auto an = std::ranges::size(lhs.digits), bn = std::ranges::size(m.value().digits);
+  const auto k = std::min(an, bn) * 3 / 10;
+  if (!m.transforms(lhs) || select_mul<D>(std::max(an, bn) - k, std::min(an, bn) - k) != mul_algo::ntt) {
+    return mul_high_into(dst, lhs, m.value(), bits);
+  }
+  mul_into(dst, lhs, m);
+  return mul_2exp(dst, -bits);
 }
 
+}  // namespace details
+
+// num^exp by left-to-right sliding-window exponentiation: one squaring per bit of exp and one
+// multiplication per window of up to k bits, from a table of the odd powers num, num^3, ...,
+// num^(2^k - 1). Longer exponents use wider windows.
 template <container C>
 constexpr z<C> pow(const z<C>& num, int exp) {
   assert(exp >= 0);
-  z<C> res = details::one<C>();
-  if (exp > 0) {
-    for (int i = 0; i < exp; ++i) {
-      res = mul_n(res, num);
-    }
-  } else if (exp == 0) {
-    return res;
-  } else [[unlikely]] {
+  if (exp == 0) {
+    return details::one<C>();
+  } else if (exp < 0) [[unlikely]] {
     throw negative_zpow_error{};
   }
+
+  const auto e = static_cast<unsigned>(exp);
+  const int bits = std::bit_width(e);
+  const int k = bits <= 6 ? 1 : bits <= 16 ? 3 : 4;
+  std::array<z<C>, 8> odd;
+  odd[0] = num;
+  odd[0].sgn = sign::positive;
+  if (k > 1) {
+    z<C> sq;
+    mul_into(sq, odd[0], odd[0]);
+    for (auto i = 1uz; i < (1uz << (k - 1)); ++i) mul_into(odd[i], odd[i - 1], sq);
+  }
+
+  z<C> res, t;
+  for (int i = bits - 1; i >= 0;) {
+    if (((e >> i) & 1) == 0) {
+      mul_into(t, res, res);
+      std::swap(res, t);
+      --i;
+      continue;
+    }
+    // the window e[i..j] starts and ends with a set bit
+    int j = std::max(i - k + 1, 0);
+    while (((e >> j) & 1) == 0) ++j;
+    const auto w = (e >> j) & ((1u << (i - j + 1)) - 1);
+    if (i == bits - 1) {
+      res = odd[w >> 1];
+    } else {
+      for (int l = j; l <= i; ++l) {
+        mul_into(t, res, res);
+        std::swap(res, t);
+      }
+      mul_into(t, res, odd[w >> 1]);
+      std::swap(res, t);
+    }
+    i = j - 1;
+  }
   if (is_negative(num) && (exp % 2 == 1)) {
     res.sgn = sign::negative;
   }
   return res;
 }
 
+// base^exp for a machine-word base. The factors of two of base become a final shift, and the odd
+// part is applied as a word, so each step costs one squaring and at most one pass over the digits.
+template <container C, std::unsigned_integral U>
+constexpr z<C> pow_ui(U base, unsigned exp) {
+  if (exp == 0) {
+    return details::one<C>();
+  } else if (base == 0) {
+    return z<C>{};
+  }
+  const int tz = std::countr_zero(base);
+  const auto shift = static_cast<int64_t>(tz) * exp;
+  if (shift > std::numeric_limits<int>::max()) [[unlikely]] {
+    throw precision_overflow_error{};
+  }
+  const U odd = base >> tz;
+  auto res = create<C>(odd);
+  if (odd > 1) {
+    z<C> t;
+    for (int i = std::bit_width(exp) - 2; i >= 0; --i) {
+      mul_into(t, res, res);
+      std::swap(res, t);
+      if ((exp >> i) & 1) mul_ui(res, res, odd);
+    }
+  }
+  return mul_2exp(res, static_cast<int>(shift));
+}
+
+namespace details {
+
+// floor(num^(1/k)) for num > 0 and k >= 2, by Newton's iteration from above. The root of
+// num / 2^(k*h), for h a little under half the bits of the root, comes from recursion and scales up
+// into a bound accurate to half the bits, so each level only needs a couple of steps at its own
+// precision. Roots of up to 64 bits start from a power of two.
+template <container C>
+constexpr z<C> root_newton(const z<C>& num, int k) {
+  const int rbits = (bit_length(num.digits) + k - 1) / k;
+  const int h = (rbits - std::bit_width(static_cast<unsigned>(k)) - 2) / 2;
+  z<C> x0;
+  if (rbits <= 64 || h <= 0) {
+    x0 = one<C>();
+    mul_2exp(x0, rbits);
+  } else {
+    x0 = add_n(root_newton(mul_2exp(num, -k * h), k), one<C>());
+    mul_2exp(x0, h);
+  }
+
+  // The iterates stay at or above the root, so the first one whose k-th power fits is the root.
+  const auto uk = static_cast<unsigned>(k);
+  auto p = pow(x0, k - 1);
+  z<C> x1;
+  for (;;) {
+    // x1 = ((k - 1) * x0 + num / x0^(k - 1)) / k
+    auto [t, _] = div_n(num, p);
+    addmul_ui(t, x0, uk - 1);
+    div_ui(x1, t, uk);
+    if (cmp_n(x1, x0) >= 0) {
+      return x0;
+    }
+    p = pow(x1, k - 1);
+    if (cmp_n(mul_n(p, x1), num) <= 0) {
+      return x1;
+    }
+    std::swap(x0, x1);
+  }
+}
+
+// Karatsuba square root (Zimmermann; Brent and Zimmermann, Modern Computer Arithmetic, Algorithm
+// 1.12) of num > 0: s = floor(sqrt(num)) and r = num - s^2. The square root s' of the top half of
+// the bits comes from recursion and the rest of s from one division by 2s', so the cost is about
+// that of a division of num by its square root.
+template <container C>
+constexpr void sqrtrem_rec(z<C>& s, z<C>& r, const z<C>& num) {
+  const auto bits = bit_length(num.digits);
+  if (bits <= 64) {
+    s = root_newton(num, 2);
+    r = sub(num, sqr_n(s));
+    return;
+  }
+  // num = (a3 * 2^l + a2) * 2^2l + a1 * 2^l + a0, where a3 * 2^l + a2 has at least half the bits
+  const int l = (bits + 1) / 4;
+  z<C> s1, r1;
+  sqrtrem_rec(s1, r1, mul_2exp(num, -2 * l));
+  auto a = mul_2exp(num, -l);
+  a = add_n(mul_2exp(r1, l), low_bits(a, static_cast<size_t>(l)));
+  auto [q, u] = div_n(std::move(a), add_n(s1, s1));
+  s = add_n(mul_2exp(s1, l), q);
+  r = sub(add_n(mul_2exp(u, l), low_bits(num, static_cast<size_t>(l))), sqr_n(q));
+  if (is_negative(r)) {
+    s = sub_n(s, one<C>());
+    r = add(r, add_n(add_n(s, s), one<C>()));
+  }
+}
+
+}  // namespace details
+
+// s = floor(sqrt(num)) and the remainder r = num - s^2, which is zero exactly when num is a
+// perfect square.
+template <container C>
+constexpr auto sqrtrem(const z<C>& num) {
+  struct result_t {
+    z<C> s;
+    z<C> r;
+  };
+
+  if (is_negative(num)) [[unlikely]] {
+    throw negative_radicand_error{};
+  }
+  result_t res;
+  if (!is_zero(num)) {
+    details::sqrtrem_rec(res.s, res.r, num);
+  }
+  return res;
+}
+
 template <container C>
 constexpr z<C> root(const z<C>& num, int k) {
   if (is_negative(num)) [[unlikely]] {
@@ -563,23 +2752,340 @@ constexpr z<C> root(const z<C>& num, int k) {
     return details::one<C>();
   } else if (k == 1 || is_zero(num)) {
     return num;
+  } else if (k == 2) {
+    return sqrtrem(num).s;
   }
+  return details::root_newton(num, k);
+}
 
-  auto x0 = details::one<C>();
-  mul_2exp(x0, (details::bit_length(num.digits) + k - 1) / k);
+namespace details {
 
-  z<C> x1;
+// Bits [shift, shift + 64) of |v|.
+template <container C>
+constexpr uint64_t bits_at(const z<C>& v, int shift) {
+  using D = typename z<C>::digit_type;
+  constexpr int dbits = static_cast<int>(sizeof(D) * CHAR_BIT);
+  const auto n = std::ranges::size(v.digits);
+  uint64_t w = 0;
+  int pos = -(shift % dbits);  // position in w of bit 0 of digit i
+  for (auto i = static_cast<size_t>(shift / dbits); i < n && pos < 64; ++i, pos += dbits) {
+    const auto d = static_cast<uint64_t>(v.digits[i]);
+    w |= pos >= 0 ? d << pos : d >> -pos;
+  }
+  return w;
+}
+
+// dst += src * v for a signed word v.
+template <container C>
+constexpr z<C>& addmul_word(z<C>& dst, const z<C>& src, int64_t v) {
+  return v >= 0 ? addmul_ui(dst, src, static_cast<uint64_t>(v)) : submul_ui(dst, src, uabs(v));
+}
+
+// Transform of a pair in a GCD computation, (x, y) -> (m11 x + m12 y, m21 x + m22 y). It is a
+// product of reduction steps, so its determinant is +-1 and the GCD of the pair is preserved.
+template <container C>
+struct gcd_matrix {
+  z<C> m11 = one<C>();
+  z<C> m12;
+  z<C> m21;
+  z<C> m22 = one<C>();
+};
+
+// (x, y) = m (x, y)
+template <container C>
+constexpr void gcd_apply(const gcd_matrix<C>& m, z<C>& x, z<C>& y) {
+  z<C> t;
+  mul_into(t, m.m21, x);
+  addmul(t, m.m22, y);
+  mul_into(x, m.m11, x);
+  addmul(x, m.m12, y);
+  y = std::move(t);
+}
+
+// m = r m
+template <container C>
+constexpr void gcd_compose(const gcd_matrix<C>& r, gcd_matrix<C>& m) {
+  if (is_zero(m.m12) && is_zero(m.m21) && m.m11 == one<C>() && m.m22 == one<C>()) {
+    m = r;
+  } else {
+    gcd_apply(r, m.m11, m.m21);
+    gcd_apply(r, m.m12, m.m22);
+  }
+}
+
+// Lehmer's inner loop (Knuth, The Art of Computer Programming, Algorithm 4.5.2L) on the leading
+// bits x >= y of a pair, at most 62 of them, with word cofactors. It only takes the quotients that
+// the leading bits determine, so the pair maps to (a x + b y, c x + d y) with the exact remainders.
+// A positive lim also stops it before a remainder, with its error bound, drops below lim. b == 0
+// when no quotient could be taken.
+struct lehmer_matrix {
+  int64_t a = 1, b = 0, c = 0, d = 1;
+};
+
+constexpr lehmer_matrix lehmer(int64_t x, int64_t y, int64_t lim) {
+  lehmer_matrix m;
+  while (y + m.c != 0 && y + m.d != 0) {
+    const auto q = (x + m.a) / (y + m.c);
+    if (q != (x + m.b) / (y + m.d)) break;
+    const auto r = x - q * y;
+    const auto c = m.a - q * m.c, d = m.b - q * m.d;
+    if (lim > 0 && r < lim + (c < 0 ? -c : c) + (d < 0 ? -d : d)) break;
+    m = {.a = m.c, .b = m.d, .c = c, .d = d};
+    x = std::exchange(y, r);
+  }
+  return m;
+}
+
+// (x, y) = (a x + b y, c x + d y)
+template <container C>
+constexpr void lehmer_apply(const lehmer_matrix& m, z<C>& x, z<C>& y) {
+  z<C> t;
+  mul_si(t, x, m.c);
+  addmul_word(t, y, m.d);
+  mul_si(x, x, m.a);
+  addmul_word(x, y, m.b);
+  y = std::move(t);
+}
+
+// One step of hgcd: subtracts from the larger of a, b the largest multiple of the smaller that
+// leaves it at least 2^s, and updates m to match. Returns false when |a - b| < 2^s.
+template <container C>
+constexpr bool hgcd_step(z<C>& a, z<C>& b, int s, gcd_matrix<C>& m) {
+  const bool swapped = cmp_n(a, b) < 0;
+  auto& x = swapped ? b : a;
+  const auto& y = swapped ? a : b;
+  auto p = one<C>();
+  mul_2exp(p, s);
+  auto d = sub(x, p);
+  if (is_negative(d) || cmp_n(d, y) < 0) return false;
+  auto [q, r] = div_n(std::move(d), y);
+  x = add_n(r, p);
+  auto& r1 = swapped ? m.m21 : m.m11;
+  auto& r2 = swapped ? m.m22 : m.m12;
+  submul(r1, q, swapped ? m.m11 : m.m21);
+  submul(r2, q, swapped ? m.m12 : m.m22);
+  return true;
+}
+
+// hgcd below hgcd_threshold: batches of Lehmer steps while the pair is well above 2^s, then single
+// steps.
+template <container C>
+constexpr void hgcd_basecase(z<C>& a, z<C>& b, int s, gcd_matrix<C>& m) {
   for (;;) {
-    auto t1 = mul_n(create<C>(k - 1), x0);
-    auto [t2, _] = div(num, pow(x0, k - 1));
-    x1 = div_n(add_n(t1, t2), create<C>(k)).q;
-    if (cmp_n(x1, x0) >= 0) {
-      return x0;
+    const bool swapped = cmp_n(a, b) < 0;
+    const auto& x = swapped ? b : a;
+    const auto& y = swapped ? a : b;
+    const int n = bit_length(x.digits);
+    if (n - s <= 32) break;
+    const int h = std::max(n - 62, 0);
+    // the margin keeps both remainders at least 2^s
+    const auto lm = lehmer(static_cast<int64_t>(bits_at(x, h)), static_cast<int64_t>(bits_at(y, h)),
+                           s >= h ? int64_t{1} << (s - h) : 1);
+    if (lm.b == 0) {
+      // the smaller is too short for the leading bits to fix a quotient
+      if (!hgcd_step(a, b, s, m)) return;
+      continue;
+    }
+    // on (a, b), the matrix is [[a, b], [c, d]], or [[d, c], [b, a]] with the roles swapped
+    const auto r = swapped ? lehmer_matrix{.a = lm.d, .b = lm.c, .c = lm.b, .d = lm.a} : lm;
+    lehmer_apply(r, a, b);
+    assert(bit_length(a.digits) > s && bit_length(b.digits) > s);
+    lehmer_apply(r, m.m11, m.m21);
+    lehmer_apply(r, m.m12, m.m22);
+  }
+  while (hgcd_step(a, b, s, m)) {
+  }
+}
+
+// Half GCD (Möller, On Schönhage's algorithm and subquadratic integer GCD computation): for a, b of
+// at most n bits and s = n / 2 + 1, reduces the pair with steps that keep both at least 2^s, until
+// |a - b| < 2^s, and applies the transform to m. The first half of the work comes from the top
+// bits of the pair, the second from the top bits of what is left. A transform from the top bits
+// that would take the pair below 2^s is dropped, so the pair only ever goes through exact steps.
+template <container C>
+constexpr void hgcd(z<C>& a, z<C>& b, gcd_matrix<C>& m) {
+  using D = typename z<C>::digit_type;
+  const int n = std::max(bit_length(a.digits), bit_length(b.digits));
+  const int s = n / 2 + 1;
+  if (bit_length(a.digits) <= s || bit_length(b.digits) <= s) return;
+  if (n < static_cast<int>(hgcd_threshold<global_config_tag> * sizeof(D) * CHAR_BIT)) {
+    hgcd_basecase(a, b, s, m);
+    return;
+  }
+
+  // Reduces the pair by the transform of its top bits, from bit k on. The top bits come out of the
+  // recursion already reduced, so the transform only multiplies the k low bits.
+  auto reduce_top = [&](int k) {
+    auto ta = a, tb = b;
+    mul_2exp(ta, -k);
+    mul_2exp(tb, -k);
+    gcd_matrix<C> r;
+    hgcd(ta, tb, r);
+    auto la = low_bits(a, static_cast<size_t>(k)), lb = low_bits(b, static_cast<size_t>(k));
+    gcd_apply(r, la, lb);
+    auto na = add(mul_2exp(ta, k), la), nb = add(mul_2exp(tb, k), lb);
+    if (!is_negative(na) && !is_negative(nb) && bit_length(na.digits) > s && bit_length(nb.digits) > s) {
+      a = std::move(na);
+      b = std::move(nb);
+      gcd_compose(r, m);
+    }
+  };
+
+  // A failed step means |a - b| < 2^s, so the pair is done. This is how a pair with a large GCD,
+  // which stops reducing well above 2^s, ends.
+  reduce_top(n / 2);
+  while (std::max(bit_length(a.digits), bit_length(b.digits)) > 3 * n / 4 + 1) {
+    if (!hgcd_step(a, b, s, m)) return;
+  }
+  // At about 3n/4 bits, the top 2(n2 - s) bits of the pair, at most about n/2, fix the second half.
+  const int n2 = std::max(bit_length(a.digits), bit_length(b.digits));
+  const int k = 2 * s - n2;
+  if (n2 > s + 1 && k > 0) {
+    reduce_top(k);
+  }
+  while (hgcd_step(a, b, s, m)) {
+  }
+}
+
+// Euclid's algorithm on a >= b >= 0, leaving gcd(a, b) in a. With Ext, (u, v) goes through the
+// same transforms as (a, b). Pairs of similar size take Lehmer steps, and from hgcd_threshold
+// digits on half-GCD reductions; a division step follows each or covers unbalanced pairs.
+template <bool Ext, container C>
+constexpr void gcd_reduce(z<C>& a, z<C>& b, z<C>& u, z<C>& v) {
+  auto div_step = [&] {
+    auto [q, r] = div_n(a, b);
+    a = std::exchange(b, std::move(r));
+    if constexpr (Ext) {
+      submul(u, q, v);
+      std::swap(u, v);
+    }
+  };
+
+  while (!is_zero(b)) {
+    const auto an = std::ranges::size(a.digits), bn = std::ranges::size(b.digits);
+    if (bn >= hgcd_threshold<global_config_tag>) {
+      gcd_matrix<C> m;
+      hgcd(a, b, m);
+      if constexpr (Ext) gcd_apply(m, u, v);
+      if (cmp_n(a, b) < 0) {
+        std::swap(a, b);
+        if constexpr (Ext) std::swap(u, v);
+      }
+      div_step();
+    } else if (an > bn + 1) {
+      div_step();
+    } else {
+      const int h = std::max(bit_length(a.digits) - 62, 0);
+      const auto lm = lehmer(static_cast<int64_t>(bits_at(a, h)), static_cast<int64_t>(bits_at(b, h)), 0);
+      if (lm.b == 0) {
+        div_step();
+      } else {
+        lehmer_apply(lm, a, b);
+        if constexpr (Ext) lehmer_apply(lm, u, v);
+      }
     }
-    x0 = x1;
   }
 }
 
+}  // namespace details
+
+// Greatest common divisor of |a| and |b|; gcd(0, 0) = 0.
+template <container C>
+constexpr z<C> gcd(const z<C>& a, const z<C>& b) {
+  z<C> x = a, y = b;
+  x.sgn = y.sgn = sign::positive;
+  if (cmp_n(x, y) < 0) std::swap(x, y);
+  z<C> u, v;
+  details::gcd_reduce<false>(x, y, u, v);
+  return x;
+}
+
+// g = gcd(a, b) with cofactors, g = a * s + b * t, where |s| <= |b| / (2g) for b != 0.
+template <container C>
+constexpr auto gcdext(const z<C>& a, const z<C>& b) {
+  struct result_t {
+    z<C> g;
+    z<C> s;
+    z<C> t;
+  };
+
+  result_t res;
+  if (is_zero(b)) {
+    res.g = a;
+    res.g.sgn = sign::positive;
+    if (!is_zero(a)) res.s = create<C>(is_negative(a) ? -1 : 1);
+    return res;
+  }
+  z<C> x = a, y = b, u = details::one<C>(), v;
+  x.sgn = y.sgn = sign::positive;
+  if (cmp_n(x, y) < 0) {
+    std::swap(x, y);
+    std::swap(u, v);
+  }
+  // x = u |a| (mod |b|) and y = v |a| (mod |b|) throughout
+  details::gcd_reduce<true>(x, y, u, v);
+  res.g = std::move(x);
+
+  // reduce s = u modulo |b| / g into (-|b| / 2g, |b| / 2g], then t = (g - s |a|) / |b|
+  auto bg = div_n(b, res.g).q;
+  auto [q, r] = floor_div(u, bg);
+  normalize(r);
+  if (cmp_n(add_n(r, r), bg) > 0) r = sub(r, bg);
+  if (is_negative(a)) negate(r);
+  res.s = std::move(r);
+  res.t = div(sub(res.g, mul(res.s, a)), b).q;
+  normalize(res.t);
+  return res;
+}
+
+// Least common multiple of |a| and |b|; zero if either is zero.
+template <container C>
+constexpr z<C> lcm(const z<C>& a, const z<C>& b) {
+  if (is_zero(a) || is_zero(b)) {
+    return z<C>{};
+  }
+  auto res = mul_n(div_n(a, gcd(a, b)).q, b);
+  res.sgn = sign::positive;
+  return res;
+}
+
+}  // namespace epx
+
+#if defined(EPSILON_EXTERN_TEMPLATE)
+namespace epx {
+
+// Functions that return a deduced type, such as div_n and gcdext, are left out: an explicit
+// instantiation declaration does not stop them from being instantiated wherever they are used.
+EPSILON_EXTERN_TEMPLATE int cmp_n(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> add_n(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> sub_n(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> mul_n(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> sqr_n(const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> add(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> sub(const z<>&, z<>);
+EPSILON_EXTERN_TEMPLATE z<> mul(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> sqr(const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& add_to(z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& sub_to(z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& mul_into(z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& addmul(z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& submul(z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE void floor_div_into(z<>&, z<>&, const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<>& mul_2exp(z<>&, int);
+EPSILON_EXTERN_TEMPLATE z<>& mul_4exp(z<>&, int);
+EPSILON_EXTERN_TEMPLATE z<> mul_2exp(const z<>&, int);
+EPSILON_EXTERN_TEMPLATE z<> mul_4exp(const z<>&, int);
+EPSILON_EXTERN_TEMPLATE class divisor<default_container_type>;
+EPSILON_EXTERN_TEMPLATE void floor_div_into(z<>&, z<>&, const z<>&, const divisor<default_container_type>&);
+EPSILON_EXTERN_TEMPLATE class prepared_multiplier<default_container_type>;
+EPSILON_EXTERN_TEMPLATE z<>& mul_into(z<>&, const z<>&, const prepared_multiplier<default_container_type>&);
+EPSILON_EXTERN_TEMPLATE z<> mul(const z<>&, const prepared_multiplier<default_container_type>&);
+EPSILON_EXTERN_TEMPLATE z<> pow(const z<>&, int);
+EPSILON_EXTERN_TEMPLATE z<> root(const z<>&, int);
+EPSILON_EXTERN_TEMPLATE z<> gcd(const z<>&, const z<>&);
+EPSILON_EXTERN_TEMPLATE z<> lcm(const z<>&, const z<>&);
+
 }  // namespace epx
+#endif
 
 #endif
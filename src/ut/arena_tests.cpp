@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <memory_resource>
+
+// epx
+#include "arena.hpp"
+#include "chars.hpp"
+#include "r.hpp"
+#include "z.hpp"
+
+// ut
+#include "def.hpp"
+
+namespace epxut {
+
+using az = epx::z<epx::arena_vector<uint32_t>>;
+
+static_assert(epx::container<az::container_type>);
+
+namespace {
+
+// Forwards to the default resource and counts the allocations it serves.
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  size_t count = 0;
+
+ private:
+  void* do_allocate(size_t bytes, size_t align) override {
+    ++count;
+    return std::pmr::get_default_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    std::pmr::get_default_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Serves allocations from new and delete and tracks the most bytes held at once.
+class peak_resource : public std::pmr::memory_resource {
+ public:
+  size_t live = 0;
+  size_t peak = 0;
+
+ private:
+  void* do_allocate(size_t bytes, size_t align) override {
+    peak = std::max(peak, live += bytes);
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    live -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override { return this == &other; }
+};
+
+}  // namespace
+
+TEST(arena_tests, scope) {
+  counting_resource outer, inner;
+  const az a = epx::try_from_chars<az::container_type>("123456789012345678901234567890").value();
+  EXPECT_EQ(std::pmr::get_default_resource(), a.digits.get_allocator().resource());
+  {
+    epx::arena_scope s1(&outer);
+    auto b = epx::mul_n(a, a);
+    EXPECT_EQ(&outer, b.digits.get_allocator().resource());
+    {
+      epx::arena_scope s2(&inner);
+      auto c = epx::mul_n(b, a);
+      EXPECT_EQ(&inner, c.digits.get_allocator().resource());
+      EXPECT_EQ(&inner, az{c}.digits.get_allocator().resource());
+      b = c;  // copies into the storage of the outer scope
+      EXPECT_EQ(&outer, b.digits.get_allocator().resource());
+    }
+    EXPECT_EQ(&outer, epx::add_n(a, b).digits.get_allocator().resource());
+    const auto la = stolz("123456789012345678901234567890");
+    EXPECT_EQ(epx::to_string(epx::mul_n(epx::mul_n(la, la), la)), epx::to_string(b));
+  }
+  EXPECT_GT(outer.count, 0u);
+  EXPECT_GT(inner.count, 0u);
+  EXPECT_EQ(std::pmr::get_default_resource(), az{a}.digits.get_allocator().resource());
+}
+
+TEST(arena_tests, scratch_arena) {
+  const auto a = make_digits<az>(100, 3), b = make_digits<az>(40, 7);
+  counting_resource outer;
+  az q;
+  {
+    epx::arena_scope scope(&outer);
+    q = epx::details::with_scratch_arena<az::container_type>([&] {
+      return epx::div_n(epx::mul_n(a, a), b).q;
+    });
+  }
+  // Only the copied-out result comes from the enclosing scope; the temporaries used a scratch arena.
+  EXPECT_EQ(1u, outer.count);
+  const auto la = make_digits<lz>(100, 3), lb = make_digits<lz>(40, 7);
+  EXPECT_EQ(epx::to_string(epx::div_n(epx::mul_n(la, la), lb).q), epx::to_string(q));
+}
+
+TEST(arena_tests, scratch_arena_reuse) {
+  const auto a = make_digits<az>(1000, 3);
+  peak_resource upstream;
+  auto* prev = std::pmr::set_default_resource(&upstream);
+  const auto s = epx::details::with_scratch_arena<az::container_type>([&] {
+    az acc;
+    for (int i = 0; i < 100; ++i) {
+      // each term frees its temporaries before the next one takes as many
+      acc = epx::add_n(acc, epx::mul_n(a, a));
+    }
+    return acc;
+  });
+  std::pmr::set_default_resource(prev);
+  // 100 terms of 2000 digits would hold 800 kB without reuse
+  EXPECT_LT(upstream.peak, 100'000u);
+  EXPECT_EQ(epx::to_string(epx::mul_n(epx::mul_n(a, a), az{.digits = {100}})), epx::to_string(s));
+}
+
+TEST(arena_tests, r_series) {
+  using C = az::container_type;
+  auto one = epx::make_q(epx::details::one<C>(), epx::details::one<C>());
+  auto four = epx::make_q(epx::create<C>(4), epx::details::one<C>());
+  auto pi = epx::mul(four, epx::arctan(one));
+  std::string s;
+  {
+    epx::arena_scope scope;
+    s = epx::to_string(pi, 40);
+  }
+  EXPECT_EQ("3.1415926535897932384626433832795028841972", s);
+  EXPECT_EQ("2.7182818284590452353602874713526624977572", epx::to_string(epx::exp(one), 40));
+  EXPECT_EQ("0.8414709848078965066525023216302989996226", epx::to_string(epx::sin(one), 40));
+  auto two = epx::make_q(epx::create<C>(2), epx::details::one<C>());
+  EXPECT_EQ("0.6931471805599453094172321214581765680755", epx::to_string(epx::log(two), 40));
+}
+
+}  // namespace epxut
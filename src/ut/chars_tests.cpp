@@ -210,6 +210,18 @@ TEST(chars_tests, z_to_decimal_string) {
   }
 }
 
+TEST(chars_tests, z_to_decimal_string_chunks) {
+  // decimal chunks with inner and leading zeros, in every digit width
+  for (std::string_view str : {"1000000000000000000000000000000000000000000000000000000000000000000001",
+                               "-9000000000000000000900000000000000000090000000000000000009",
+                               "18446744073709551616", "10000000000000000000", "9999999999999999999"}) {
+    EXPECT_EQ(str, epx::to_string(stosz(str)));
+    EXPECT_EQ(str, epx::to_string(stomz(str)));
+    EXPECT_EQ(str, epx::to_string(stolz(str)));
+    EXPECT_EQ(str, epx::to_string(epx::try_from_chars<hz::container_type>(str).value()));
+  }
+}
+
 TEST(chars_tests, r_to_decimal_string) {
   {
     auto q = epx::make_q(stosz("0"), stosz("1"));
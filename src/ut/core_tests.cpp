@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <vector>
+
+// epx
+#include "chars.hpp"
+#include "core.hpp"
+#include "r.hpp"
+#include "z.hpp"
+
+// ut
+#include "def.hpp"
+
+namespace epxut {
+
+using dz = epx::z<>;
+using epx::core::isa;
+
+TEST(core_tests, kernels) {
+  using D = epx::core::limb_kernels::digit_type;
+  const auto& selected = epx::core::kernels();
+  ASSERT_NE(nullptr, epx::core::kernels(isa::baseline));
+  EXPECT_EQ(&selected, epx::core::kernels(selected.level));
+  EXPECT_EQ(&selected, epx::core::active_kernels);
+  for (auto level : {isa::baseline, isa::bmi2_adx}) {
+    const auto* k = epx::core::kernels(level);
+    if (k == nullptr) {
+      EXPECT_GT(level, selected.level);
+      continue;
+    }
+    EXPECT_EQ(level, k->level);
+    for (size_t an : {1uz, 2uz, 7uz, 31uz}) {
+      for (size_t bn : {1uz, 5uz, an}) {
+        const auto a = make_digits<dz>(an, 3).digits, b = make_digits<dz>(bn, 5).digits;
+        std::vector<D> expected(an + bn), r(an + bn, D{7});
+        epx::details::mul_basecase_generic<D>(expected, a, b);
+        k->mul_basecase(r.data(), a.data(), an, b.data(), bn);
+        EXPECT_EQ(expected, r);
+        expected.resize(2 * an);
+        r.assign(2 * an, D{7});
+        epx::details::sqr_basecase_generic<D>(expected, a);
+        k->sqr_basecase(r.data(), a.data(), an);
+        EXPECT_EQ(expected, r);
+      }
+      // (B^n - 1) + (B^n - 1)(B - 1) = (B^n - 1)B carries out of every partial sum
+      const std::vector<D> ones(an, ~D{0});
+      std::vector<D> expected(ones), r(ones);
+      expected[0] = 0;
+      EXPECT_EQ(~D{0}, k->addmul_1(r.data(), ones.data(), an, ~D{0}));
+      EXPECT_EQ(expected, r);
+    }
+  }
+}
+
+TEST(core_tests, instantiations) {
+  using C = epx::default_container_type;
+  const auto a = make_digits<dz>(60, 3), b = make_digits<dz>(25, 7);
+  auto [q, r] = epx::div(a, b);
+  EXPECT_EQ(a, epx::add(epx::mul(q, b), r));
+  EXPECT_EQ(epx::to_string(epx::sqr(a)), epx::to_string(epx::mul(a, a)));
+  const auto digits = "1234567890123456789012345678901234567890";
+  EXPECT_EQ(digits, epx::to_string(epx::try_from_chars<C>(digits).value()));
+  const auto one = epx::make_q(epx::create<C>(1), epx::create<C>(1));
+  EXPECT_EQ("2.7182818284590452353602874713526624977572", epx::to_string(epx::exp(one), 40));
+}
+
+}  // namespace epxut
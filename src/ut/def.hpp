@@ -4,26 +4,77 @@
 #pragma once
 
 // std
+#include <algorithm>
+#include <climits>
 #include <concepts>
 #include <cstdint>
+#include <limits>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 // epx
 #include "chars.hpp"
+#include "small_vector.hpp"
 
 namespace epxut {
 
 using sz = epx::z<std::vector<uint8_t>>;
 using mz = epx::z<std::vector<uint16_t>>;
 using lz = epx::z<std::vector<uint32_t>>;
+using svz = epx::z<epx::small_vector<uint32_t>>;
+using hz = epx::z<std::vector<uint64_t>>;
 
 constexpr sz stosz(std::string_view chars) { return epx::try_from_chars<sz::container_type>(chars).value(); }
 constexpr mz stomz(std::string_view chars) { return epx::try_from_chars<mz::container_type>(chars).value(); }
 constexpr lz stolz(std::string_view chars) { return epx::try_from_chars<lz::container_type>(chars).value(); }
+constexpr svz stosvz(std::string_view chars) { return epx::try_from_chars<svz::container_type>(chars).value(); }
 template <std::integral T>
 constexpr sz create_sz(T val) {
   return epx::create<sz::container_type>(val);
 }
 
+// Deterministic pseudo-random operand with n digits, for exercising the large-operand kernels.
+template <class Z>
+constexpr Z make_digits(size_t n, uint32_t seed) {
+  Z num;
+  for (size_t i = 0; i < n; ++i) {
+    typename Z::digit_type d = 0;
+    for (size_t k = 0; k < sizeof(d); k += sizeof(uint16_t)) {
+      seed = seed * 1664525u + 1013904223u;
+      d = static_cast<typename Z::digit_type>((d << 8 << 8) | (seed >> 16));
+    }
+    num.digits.push_back(d);
+  }
+  epx::normalize(num);
+  return num;
+}
+
+// Reference product built from single-digit multiplications, which always take the schoolbook path.
+template <class Z>
+constexpr Z mul_by_digits(const Z& lhs, const Z& rhs) {
+  using D = typename Z::digit_type;
+  Z res;
+  for (size_t j = 0; j < rhs.digits.size(); ++j) {
+    auto part = epx::mul_n(lhs, Z{.digits = {rhs.digits[j]}});
+    epx::mul_2exp(part, static_cast<int>(j * sizeof(D) * CHAR_BIT));
+    res = epx::add_n(res, part);
+  }
+  return res;
+}
+
+// B^n - 1, with every digit at its maximum, and its square B^2n - 2*B^n + 1, whose products carry
+// through every digit.
+template <class Z>
+constexpr std::pair<Z, Z> max_digits_square(size_t n) {
+  using D = typename Z::digit_type;
+  constexpr D m = std::numeric_limits<D>::max();
+  Z a{.digits = typename Z::container_type(n, m)};
+  Z sq{.digits = typename Z::container_type(2 * n, m)};
+  std::fill_n(sq.digits.begin(), n + 1, D{0});
+  sq.digits[0] = 1;
+  sq.digits[n] = m - 1;
+  return {a, sq};
+}
+
 }  // namespace epxut
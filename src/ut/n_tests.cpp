@@ -4,6 +4,9 @@
 // gtest
 #include <gtest/gtest.h>
 
+// std
+#include <limits>
+
 // epx
 #include "z.hpp"
 
@@ -134,6 +137,36 @@ TEST(n_tests, sub_n) {
   }
 }
 
+TEST(n_tests, add_sub_n_carry_chain) {
+  {
+    // B^n - 1 + 1 = B^n ripples a carry through every digit, across the unrolled and tail loops.
+    for (auto n : {1uz, 3uz, 4uz, 5uz, 9uz, 64uz}) {
+      lz a{.digits = lz::container_type(n, 0xffffffff)};
+      lz one{.digits = {1}};
+      lz expected{.digits = lz::container_type(n + 1, 0)};
+      expected.digits[n] = 1;
+      EXPECT_EQ(expected, epx::add_n(a, one));
+      EXPECT_EQ(expected, epx::add_n(one, a));
+      EXPECT_EQ(a, epx::sub_n(expected, one));
+    }
+  }
+  for (auto [an, bn] : {std::pair{7uz, 7uz}, {13uz, 5uz}, {100uz, 37uz}}) {
+    auto a = make_digits<lz>(an, 23);
+    auto b = make_digits<lz>(bn, 24);
+    auto s = epx::add_n(a, b);
+    EXPECT_EQ(s, epx::add_n(b, a));
+    EXPECT_EQ(a, epx::sub_n(s, b));
+    EXPECT_EQ(b, epx::sub_n(s, a));
+  }
+  {
+    auto a = make_digits<hz>(21, 25);
+    auto b = make_digits<hz>(18, 26);
+    auto s = epx::add_n(a, b);
+    EXPECT_EQ(a, epx::sub_n(s, b));
+    EXPECT_EQ(epx::mul_n(epx::add_n(a, a), b), epx::add_n(epx::mul_n(a, b), epx::mul_n(a, b)));
+  }
+}
+
 TEST(n_tests, mul_n) {
   {
     sz zero;
@@ -192,6 +225,196 @@ TEST(n_tests, mul_n) {
   }
 }
 
+TEST(n_tests, mul_n_karatsuba) {
+  for (auto [an, bn] : {std::pair{32uz, 32uz}, {33uz, 32uz}, {64uz, 40uz}, {100uz, 99uz}, {257uz, 200uz}}) {
+    auto a = make_digits<sz>(an, 1);
+    auto b = make_digits<sz>(bn, 2);
+    auto expected = mul_by_digits(a, b);
+    EXPECT_EQ(expected, epx::mul_n(a, b));
+    EXPECT_EQ(expected, epx::mul_n(b, a));
+  }
+  {
+    auto a = make_digits<mz>(150, 3);
+    auto b = make_digits<mz>(90, 4);
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+  {
+    // (B^n - 1)^2 maximizes the carries through the middle coefficient.
+    const auto [a, expected] = max_digits_square<lz>(80);
+    EXPECT_EQ(expected, epx::mul_n(a, a));
+  }
+}
+
+TEST(n_tests, mul_n_unbalanced) {
+  // |b|-digit pieces of a, with a last piece that is short, unbalanced itself, or missing
+  for (auto [an, bn] : {std::pair{65uz, 32uz}, {130uz, 64uz}, {200uz, 65uz}, {1000uz, 33uz}, {1000uz, 40uz}, {640uz, 160uz}}) {
+    auto a = make_digits<sz>(an, 24);
+    auto b = make_digits<sz>(bn, 25);
+    auto expected = mul_by_digits(a, b);
+    EXPECT_EQ(expected, epx::mul_n(a, b));
+    EXPECT_EQ(expected, epx::mul_n(b, a));
+  }
+  {
+    // Toom-sized pieces
+    auto a = make_digits<lz>(3000, 26);
+    auto b = make_digits<lz>(400, 27);
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+  {
+    // all-ones operands carry through every piece
+    mz a{.digits = mz::container_type(500, 0xffff)};
+    mz b{.digits = mz::container_type(70, 0xffff)};
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+}
+
+TEST(n_tests, mul_n_toom) {
+  for (auto [an, bn] : {std::pair{128uz, 128uz}, {200uz, 150uz}, {384uz, 384uz}, {500uz, 400uz}, {1100uz, 1000uz}}) {
+    auto a = make_digits<sz>(an, 5);
+    auto b = make_digits<sz>(bn, 6);
+    auto expected = mul_by_digits(a, b);
+    EXPECT_EQ(expected, epx::mul_n(a, b));
+    EXPECT_EQ(expected, epx::mul_n(b, a));
+  }
+  {
+    auto a = make_digits<lz>(700, 7);
+    auto b = make_digits<lz>(450, 8);
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+  {
+    // (B^n - 1)^2 has all-ones evaluation points and maximal coefficients.
+    const auto [a, expected] = max_digits_square<mz>(400);
+    EXPECT_EQ(expected, epx::mul_n(a, a));
+  }
+  {
+    // Signed operands go through mul, which only adjusts the sign of the magnitude product.
+    auto a = make_digits<sz>(300, 9);
+    auto b = make_digits<sz>(260, 10);
+    auto expected = mul_by_digits(a, b);
+    epx::negate(a);
+    epx::negate(expected);
+    EXPECT_EQ(expected, epx::mul(a, b));
+  }
+}
+
+TEST(n_tests, mul_n_ntt) {
+  {
+    auto a = make_digits<sz>(2500, 11);
+    auto b = make_digits<sz>(2049, 12);
+    auto expected = mul_by_digits(a, b);
+    EXPECT_EQ(expected, epx::mul_n(a, b));
+    EXPECT_EQ(expected, epx::mul_n(b, a));
+  }
+  {
+    auto a = make_digits<mz>(2100, 13);
+    auto b = make_digits<mz>(2100, 14);
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+  {
+    auto a = make_digits<lz>(3001, 15);
+    auto b = make_digits<lz>(2500, 16);
+    EXPECT_EQ(mul_by_digits(a, b), epx::mul_n(a, b));
+  }
+  {
+    // (B^n - 1)^2 drives every convolution term to its maximum.
+    const auto [a, expected] = max_digits_square<lz>(4096);
+    EXPECT_EQ(expected, epx::mul_n(a, a));
+  }
+}
+
+TEST(n_tests, sqr_n) {
+  {
+    sz zero;
+    EXPECT_TRUE(epx::is_zero(epx::sqr_n(zero)));
+    EXPECT_EQ((sz{.digits = {1, 254}}), epx::sqr_n(sz{.digits = {255}}));
+    EXPECT_EQ((sz{.digits = {1, 0, 254, 255}}), epx::sqr_n(sz{.digits = {255, 255}}));
+  }
+  for (auto n : {2uz, 7uz, 31uz, 32uz, 33uz, 100uz, 130uz, 400uz, 1100uz}) {
+    auto a = make_digits<sz>(n, 17);
+    auto expected = mul_by_digits(a, a);
+    EXPECT_EQ(expected, epx::sqr_n(a));
+    EXPECT_EQ(expected, epx::mul_n(a, a));  // aliased operands take the squaring path
+  }
+  {
+    auto a = make_digits<lz>(1500, 18);
+    EXPECT_EQ(mul_by_digits(a, a), epx::sqr_n(a));
+  }
+  {
+    auto a = make_digits<mz>(77, 19);
+    auto expected = mul_by_digits(a, a);
+    epx::negate(a);
+    EXPECT_EQ(expected, epx::sqr(a));
+    EXPECT_EQ(expected, epx::mul(a, a));
+  }
+}
+
+template <class Z>
+void check_mul_high(const Z& a, const Z& b, int bits) {
+  Z r;
+  epx::details::mul_high_into(r, a, b, bits);
+  const auto expected = epx::mul_2exp(epx::mul(a, b), -bits);
+  EXPECT_LE(epx::cmp_n(r, expected), 0) << bits;
+  EXPECT_GE(epx::cmp_n(epx::add_n(r, Z{.digits = {1}}), expected), 0) << bits;
+  if (!epx::is_zero(r)) {
+    EXPECT_EQ(expected.sgn, r.sgn);
+  }
+}
+
+TEST(n_tests, mul_high) {
+  // basecase, then Mulders' split from karatsuba_threshold digits on
+  for (auto [an, bn] : {std::pair{5uz, 3uz}, {31uz, 31uz}, {40uz, 33uz}, {90uz, 90uz}, {200uz, 150uz}, {300uz, 40uz}}) {
+    const auto a = make_digits<sz>(an, 20), b = make_digits<sz>(bn, 21);
+    for (int bits : {0, 7, 8, 100, 8 * static_cast<int>(bn), 8 * static_cast<int>(an), 8 * static_cast<int>(an + bn) - 5,
+                     8 * static_cast<int>(an + bn) + 3}) {
+      check_mul_high(a, b, bits);
+      check_mul_high(b, a, bits);
+      check_mul_high(a, a, bits);
+    }
+  }
+  {
+    // all-ones operands maximize the partial products left out
+    constexpr size_t n = 120;
+    const sz a{.digits = sz::container_type(n, 0xff)};
+    const sz b{.digits = sz::container_type(n - 7, 0xff)};
+    for (int bits = 0; bits <= static_cast<int>(16 * n); bits += 13) {
+      check_mul_high(a, b, bits);
+      check_mul_high(a, a, bits);
+    }
+  }
+  {
+    auto a = make_digits<lz>(700, 22);
+    const auto b = make_digits<lz>(650, 23);
+    epx::negate(a);
+    check_mul_high(a, b, 32 * 640);
+    check_mul_high(a, a, 32 * 700);
+  }
+}
+
+TEST(n_tests, hz_mul_div) {
+  for (auto [an, bn] : {std::pair{1uz, 1uz}, {20uz, 7uz}, {40uz, 33uz}, {200uz, 150uz}, {1500uz, 1200uz}}) {
+    auto a = make_digits<hz>(an, 20);
+    auto b = make_digits<hz>(bn, 21);
+    auto p = epx::mul_n(a, b);
+    EXPECT_EQ(mul_by_digits(a, b), p);
+    EXPECT_EQ(mul_by_digits(a, a), epx::sqr_n(a));
+
+    // (a * b + c) / b = a ... c, for c < b
+    auto c = make_digits<hz>(bn, 22);
+    c.digits.back() = 0;
+    epx::normalize(c);
+    auto [q, r] = epx::div_n(epx::add_n(p, c), b);
+    EXPECT_EQ(a, q);
+    EXPECT_EQ(c, r);
+  }
+  {
+    const auto [a, expected] = max_digits_square<hz>(100);
+    EXPECT_EQ(expected, epx::mul_n(a, a));
+    auto [q, r] = epx::div_n(expected, a);
+    EXPECT_EQ(a, q);
+    EXPECT_TRUE(epx::is_zero(r));
+  }
+}
+
 TEST(n_tests, div_n) {
   {
     {
@@ -294,4 +517,189 @@ TEST(n_tests, div_n) {
   }
 }
 
+TEST(n_tests, div_n_bz) {
+  // a = q * b + r with r < b, for divisors above the Burnikel-Ziegler threshold.
+  auto check = []<class Z>(const Z& a, const Z& b) {
+    auto [q, r] = epx::div_n(a, b);
+    EXPECT_LT(epx::cmp_n(r, b), 0);
+    EXPECT_EQ(a, epx::add_n(epx::mul_n(q, b), r));
+  };
+  for (auto [an, bn] : {std::pair{600uz, 256uz}, {900uz, 400uz}, {1500uz, 300uz}, {1400uz, 777uz}}) {
+    check(make_digits<sz>(an, 27), make_digits<sz>(bn, 28));
+    check(make_digits<lz>(an, 29), make_digits<lz>(bn, 30));
+  }
+  {
+    // Exact quotient, and a divisor whose top digit is small (maximal normalization shift).
+    auto b = make_digits<lz>(260, 31);
+    b.digits.back() = 1;
+    auto q = make_digits<lz>(390, 32);
+    auto [q1, r1] = epx::div_n(epx::mul_n(q, b), b);
+    EXPECT_EQ(q, q1);
+    EXPECT_TRUE(epx::is_zero(r1));
+    check(epx::sub_n(epx::mul_n(q, b), lz{.digits = {1}}), b);
+  }
+  {
+    // All-ones operands maximize the quotient digit estimates.
+    lz a{.digits = lz::container_type(800, 0xffffffff)};
+    lz b{.digits = lz::container_type(300, 0xffffffff)};
+    check(a, b);
+  }
+  check(make_digits<hz>(1000, 33), make_digits<hz>(500, 34));
+  {
+    // floor_div goes through div_n and keeps its sign conventions.
+    auto a = make_digits<mz>(800, 35);
+    auto b = make_digits<mz>(300, 36);
+    epx::negate(a);
+    auto [q, r] = epx::floor_div(a, b);
+    EXPECT_TRUE(epx::is_negative(q));
+    EXPECT_LT(epx::cmp_n(r, b), 0);
+    EXPECT_EQ(a, epx::add(epx::mul(q, b), r));
+  }
+}
+
+TEST(n_tests, div_newton) {
+  // The Newton path only kicks in for huge operands through div_n, so exercise the kernel itself.
+  auto check = []<class Z>(const Z& a, const Z& b) {
+    auto [q, r] = epx::details::div_newton(a, b);
+    EXPECT_LT(epx::cmp_n(r, b), 0);
+    EXPECT_EQ(a, epx::add_n(epx::mul_n(q, b), r));
+  };
+  check(make_digits<lz>(900, 37), make_digits<lz>(420, 38));
+  check(make_digits<lz>(2000, 39), make_digits<lz>(450, 40));  // several blocks
+  check(make_digits<lz>(1500, 41), make_digits<lz>(1000, 42));  // truncated to the top digits
+  {
+    // Exact quotient, all-ones operands.
+    lz b{.digits = lz::container_type(500, 0xffffffff)};
+    lz q{.digits = lz::container_type(450, 0xffffffff)};
+    auto [q1, r1] = epx::details::div_newton(epx::mul_n(q, b), b);
+    EXPECT_EQ(q, q1);
+    EXPECT_TRUE(epx::is_zero(r1));
+  }
+  {
+    // a * x < B^2n <= a * (x + 2), with one Newton step above the division base case.
+    constexpr size_t n = epx::newton_threshold<epx::global_config_tag> / 4 + 1;
+    auto a = make_digits<sz>(n, 43);
+    a.digits.back() |= 0x80;
+    auto x = epx::details::reciprocal(a, n);
+    auto p = epx::mul_n(a, x);
+    sz bb{.digits = sz::container_type(2 * n + 1, 0)};
+    bb.digits.back() = 1;
+    EXPECT_LT(epx::cmp_n(p, bb), 0);
+    EXPECT_LE(epx::cmp_n(bb, epx::add_n(p, epx::add_n(a, a))), 0);
+  }
+  {
+    // Barrett reduction with a precomputed reciprocal, including dividends whose top digits are >= d.
+    auto d = make_digits<lz>(300, 44);
+    d.digits.back() |= 0x80000000;
+    const auto x = epx::details::reciprocal(d, 300);
+    const auto big = epx::add_n(epx::mul_n(d, make_digits<lz>(650, 45)), make_digits<lz>(299, 46));
+    for (const auto& u : {lz{}, make_digits<lz>(299, 47), d, epx::add_n(d, d), big}) {
+      auto [q, r] = epx::details::div_barrett(u, d, x);
+      auto [eq, er] = epx::div_n(u, d);
+      EXPECT_EQ(eq, q);
+      EXPECT_EQ(er, r);
+    }
+  }
+}
+
+TEST(n_tests, div_n_newton) {
+  // div_n switches from Burnikel-Ziegler to the Newton reciprocal once the quotient, like the
+  // divisor, reaches newton_threshold digits. 8-bit digits keep operands of that size cheap.
+  constexpr size_t t = epx::newton_threshold<epx::global_config_tag>;
+  auto b = make_digits<sz>(t, 91);
+  b.digits.back() |= 0x80;
+  const auto r = make_digits<sz>(t - 1, 92);
+  for (size_t qn : {t - 1, t}) {  // Burnikel-Ziegler, then Newton
+    auto q = make_digits<sz>(qn, static_cast<uint32_t>(94 + qn - t));
+    q.digits.back() |= 0x80;
+    const auto a = epx::add_n(epx::mul_n(q, b), r);
+    ASSERT_EQ(qn + t, std::ranges::size(a.digits));  // Newton from |a| >= |b| + newton_threshold
+    auto [q1, r1] = epx::div_n(a, b);
+    EXPECT_EQ(q, q1);
+    EXPECT_EQ(r, r1);
+  }
+}
+
+TEST(n_tests, div_2by1) {
+  // every normalized 8-bit divisor against every numerator
+  for (unsigned d = 0x80; d <= 0xff; ++d) {
+    const auto v = epx::details::reciprocal_1(static_cast<uint8_t>(d));
+    for (unsigned u1 = 0; u1 < d; ++u1) {
+      for (unsigned u0 = 0; u0 <= 0xff; ++u0) {
+        auto [q, r] = epx::details::div_2by1(static_cast<uint8_t>(u1), static_cast<uint8_t>(u0),
+                                             static_cast<uint8_t>(d), v);
+        ASSERT_EQ((u1 * 256 + u0) / d, q);
+        ASSERT_EQ((u1 * 256 + u0) % d, r);
+      }
+    }
+  }
+  uint64_t seed = 1;
+  auto next = [&] { return seed = seed * 6364136223846793005ull + 1442695040888963407ull; };
+  for (int i = 0; i < 10000; ++i) {
+    const auto d = static_cast<uint32_t>(next() >> 32) | 0x80000000u;
+    const auto u1 = static_cast<uint32_t>(next() >> 32) % d, u0 = static_cast<uint32_t>(next() >> 32);
+    auto [q, r] = epx::details::div_2by1(u1, u0, d, epx::details::reciprocal_1(d));
+    const uint64_t u = (uint64_t{u1} << 32) | u0;
+    ASSERT_EQ(u / d, q);
+    ASSERT_EQ(u % d, r);
+  }
+  for (int i = 0; i < 10000; ++i) {
+    const uint64_t d = next() | (uint64_t{1} << 63);
+    const uint64_t u1 = i % 2 ? d - 1 : next() % d, u0 = next();
+    auto [q, r] = epx::details::div_2by1(u1, u0, d, epx::details::reciprocal_1(d));
+    auto [p0, p1] = epx::details::umul(q, d);  // q * d + r == u1 * B + u0
+    ASSERT_LT(r, d);
+    ASSERT_EQ(u0, p0 + r);
+    ASSERT_EQ(u1, p1 + (p0 + r < p0 ? 1u : 0u));
+  }
+}
+
+TEST(n_tests, umul_div_2d_generic) {
+  // the half-digit paths, which 64-bit digits take without a native 128-bit type
+  auto check = [](auto u1, auto u0, auto v) {
+    const auto [p0, p1] = epx::details::umul(u0, v);
+    const auto [g0, g1] = epx::details::umul_generic(u0, v);
+    ASSERT_EQ(p0, g0);
+    ASSERT_EQ(p1, g1);
+    const auto [q, r] = epx::details::div_2d(u0, u1, v);
+    const auto [gq, gr] = epx::details::div_2d_generic(u0, u1, v);
+    ASSERT_EQ(q, gq);
+    ASSERT_EQ(r, gr);
+  };
+  uint64_t seed = 3;
+  auto next = [&] { return seed = seed * 6364136223846793005ull + 1442695040888963407ull; };
+  for (int i = 0; i < 10000; ++i) {
+    // all divisor widths, with the numerator just below v * B every fourth time
+    const uint64_t v = std::max(next() >> (i % 64), uint64_t{1});
+    const uint64_t u1 = i % 4 ? next() % v : v - 1, u0 = i % 4 ? next() : ~uint64_t{0};
+    check(u1, u0, v);
+    const auto v32 = std::max(static_cast<uint32_t>(v >> 32), 1u);
+    check(static_cast<uint32_t>(u1 % v32), static_cast<uint32_t>(u0), v32);
+  }
+}
+
+TEST(n_tests, div_1) {
+  auto check = [](const auto& u) {
+    using Z = std::remove_cvref_t<decltype(u)>;
+    using D = typename Z::digit_type;
+    for (D d : {D{1}, D{3}, D{10}, static_cast<D>(std::numeric_limits<D>::max() / 3),
+                std::numeric_limits<D>::max()}) {
+      auto [q, r] = epx::div_n(u, d);
+      EXPECT_LT(r, d);
+      Z zr;
+      if (r != 0) zr.digits.push_back(r);
+      EXPECT_EQ(u, epx::add_n(epx::mul_n(q, Z{.digits = {d}}), zr));
+      Z w = u;
+      EXPECT_EQ(r, epx::details::div_1(w, w, d));  // in place
+      EXPECT_EQ(q, epx::normalize(w));
+    }
+  };
+  for (size_t n : {1uz, 2uz, 17uz, 100uz}) {
+    check(make_digits<sz>(n, 60));
+    check(make_digits<mz>(n, 61));
+    check(make_digits<lz>(n, 62));
+    check(make_digits<hz>(n, 63));
+  }
+}
+
 }  // namespace epxut
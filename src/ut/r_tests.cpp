@@ -41,6 +41,17 @@ TEST(r_tests, make_q) {
     EXPECT_EQ(stosz("-2"), q.approx(1).get());
     EXPECT_EQ(stosz("-342"), q.approx(5).get());
   }
+  {
+    // the common factor, most of both operands, is divided out up front
+    const auto t = epx::pow_ui<sz::container_type>(10u, 6000);
+    auto q = epx::make_q(epx::mul(stosz("3"), t), t);  // 3/1
+    EXPECT_EQ(stosz("48"), q.approx(2).get());
+  }
+  {
+    sz zero;
+    auto q = epx::make_q(one, zero);  // 1/0 is only rejected when approximated
+    EXPECT_THROW(q.approx(1).get(), epx::divide_by_zero_error);
+  }
 }
 
 TEST(r_tests, add) {
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cstdint>
+
+// epx
+#include "chars.hpp"
+#include "scratch.hpp"
+#include "z.hpp"
+
+// ut
+#include "def.hpp"
+
+namespace epxut {
+
+using epx::details::scratch_buffer;
+using epx::details::scratch_stack;
+
+static_assert([] {
+  scratch_buffer<uint32_t> a(3), b(5);
+  a.span()[2] = 7;
+  b.span()[4] = 9;
+  return a.span()[2] + b.span()[4] == 16;
+}());
+
+TEST(scratch_tests, stack) {
+  auto& stack = scratch_stack::local();
+  stack.release();
+  {
+    // nothing is held yet, so both blocks spill to the heap
+    scratch_buffer<uint32_t> a(100);
+    scratch_buffer<uint16_t> b(3);
+    EXPECT_EQ(0u, stack.capacity());
+    EXPECT_EQ(scratch_stack::block_size(400) + scratch_stack::block_size(6), stack.in_use());
+  }
+  // regrown to the peak once empty, which then serves the same blocks
+  EXPECT_EQ(0u, stack.in_use());
+  const auto cap = stack.capacity();
+  EXPECT_EQ(scratch_stack::block_size(400) + scratch_stack::block_size(6), cap);
+  {
+    scratch_buffer<uint32_t> a(100);
+    scratch_buffer<uint16_t> b(3);
+    EXPECT_LE(static_cast<void*>(a.span().data() + 100), static_cast<void*>(b.span().data()));
+    for (auto& d : a.span()) d = 1;
+    scratch_buffer<uint8_t> c(0);
+    EXPECT_TRUE(c.span().empty());
+  }
+  EXPECT_EQ(cap, stack.capacity());
+
+  // the stack stays within scratch_limit, however large the peak
+  {
+    scratch_buffer<uint8_t> big(epx::scratch_limit<epx::global_config_tag> + 1);
+  }
+  EXPECT_EQ(epx::scratch_limit<epx::global_config_tag>, stack.capacity());
+  stack.release();
+  EXPECT_EQ(0u, stack.capacity());
+}
+
+TEST(scratch_tests, reserve) {
+  auto& stack = scratch_stack::local();
+  stack.release();
+  const auto a = make_digits<lz>(3000, 3), b = make_digits<lz>(700, 5);
+  const auto c = make_digits<lz>(100, 7), d = make_digits<lz>(200, 9);
+  epx::reserve_scratch<lz::container_type>(3000, 700);
+  const auto cap = stack.capacity();
+  EXPECT_GT(cap, 0u);
+  // the unbalanced and Karatsuba tiers, and schoolbook division, all run from the reserved stack
+  const auto p = epx::mul_n(a, b);
+  const auto s = epx::sqr_n(c);
+  auto [q, r] = epx::div_n(a, d);
+  EXPECT_EQ(cap, stack.capacity());
+  EXPECT_EQ(0u, stack.in_use());
+
+  EXPECT_EQ(epx::to_string(mul_by_digits(a, b)), epx::to_string(p));
+  EXPECT_EQ(epx::to_string(mul_by_digits(c, c)), epx::to_string(s));
+  EXPECT_EQ(epx::to_string(a), epx::to_string(epx::add_n(epx::mul_n(q, d), r)));
+  EXPECT_LT(epx::cmp_n(r, d), 0);
+  stack.release();
+}
+
+TEST(scratch_tests, knuth_normalized) {
+  // a divisor whose top bit is already set is used without a normalized copy
+  for (size_t n : {2uz, 9uz, 40uz}) {
+    auto b = make_digits<lz>(n, 11);
+    b.digits.back() |= 0x80000000u;
+    const auto a = make_digits<lz>(3 * n + 1, 13);
+    auto [q, r] = epx::div_n(a, b);
+    EXPECT_EQ(epx::to_string(a), epx::to_string(epx::add_n(epx::mul_n(q, b), r)));
+    EXPECT_LT(epx::cmp_n(r, b), 0);
+  }
+}
+
+}  // namespace epxut
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026-present Tian Liao
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <utility>
+#include <vector>
+
+// epx
+#include "chars.hpp"
+#include "r.hpp"
+#include "small_vector.hpp"
+#include "z.hpp"
+
+// ut
+#include "def.hpp"
+
+namespace epxut {
+
+using sv = epx::small_vector<uint32_t, 4>;
+
+static_assert(epx::container<sv>);
+static_assert(std::ranges::contiguous_range<sv>);
+static_assert([] {
+  sv v = {1, 2, 3, 4};
+  v.insert(v.begin(), 3, 0u);  // spills to the heap during constant evaluation
+  return v.size() == 7 && v[3] == 1 && !v.is_inline();
+}());
+
+TEST(small_vector_tests, spill) {
+  sv v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(4u, v.capacity());
+  for (uint32_t i = 0; i < 4; ++i) v.push_back(i);
+  EXPECT_TRUE(v.is_inline());
+  v.push_back(4);
+  EXPECT_FALSE(v.is_inline());
+  EXPECT_GE(v.capacity(), 5u);
+  for (uint32_t i = 5; i < 100; ++i) v.push_back(v.back() + 1);
+  ASSERT_EQ(100u, v.size());
+  for (uint32_t i = 0; i < 100; ++i) EXPECT_EQ(i, v[i]);
+  v.pop_back();
+  EXPECT_EQ(98u, v.back());
+  v.clear();
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(small_vector_tests, insert_erase) {
+  sv v = {1, 2, 3};
+  v.insert(v.begin(), 2, 0u);
+  EXPECT_EQ((sv{0, 0, 1, 2, 3}), v);
+  v.insert(v.begin() + 3, v[4]);
+  EXPECT_EQ((sv{0, 0, 1, 3, 2, 3}), v);
+  v.erase(v.begin(), v.begin() + 2);
+  EXPECT_EQ((sv{1, 3, 2, 3}), v);
+  v.erase(v.begin() + 1);
+  EXPECT_EQ((sv{1, 2, 3}), v);
+  v.resize(6, v[0]);
+  EXPECT_EQ((sv{1, 2, 3, 1, 1, 1}), v);
+  v.resize(2);
+  EXPECT_EQ((sv{1, 2}), v);
+  EXPECT_LT((sv{1, 2}), (sv{1, 3}));
+  EXPECT_LT((sv{1, 2}), (sv{1, 2, 0}));
+}
+
+TEST(small_vector_tests, copy_move) {
+  for (size_t n : {2uz, 40uz}) {
+    sv a;
+    for (uint32_t i = 0; i < n; ++i) a.push_back(i * 7);
+    sv b = a;
+    EXPECT_EQ(a, b);
+    sv c = std::move(b);
+    EXPECT_EQ(a, c);
+    EXPECT_TRUE(b.empty());
+    sv d = {9};
+    d = c;
+    EXPECT_EQ(a, d);
+    sv e(3, 5u);
+    e = std::move(d);
+    EXPECT_EQ(a, e);
+    sv f = {1, 2};
+    swap(e, f);
+    EXPECT_EQ(a, f);
+    EXPECT_EQ((sv{1, 2}), e);
+    f = std::as_const(f);
+    EXPECT_EQ(a, f);
+  }
+}
+
+TEST(small_vector_tests, z_arith) {
+  using svc = svz::container_type;
+  // Operands on both sides of the inline capacity, checked against the std::vector container.
+  for (size_t n : {1uz, 3uz, 8uz, 20uz, 70uz, 300uz}) {
+    const auto a = make_digits<lz>(n, 5), b = make_digits<lz>(n / 2 + 1, 9);
+    const svz sa{.digits = svc(a.digits.begin(), a.digits.end())};
+    const svz sb{.digits = svc(b.digits.begin(), b.digits.end())};
+    EXPECT_EQ(epx::to_string(epx::add_n(a, b)), epx::to_string(epx::add_n(sa, sb)));
+    EXPECT_EQ(epx::to_string(epx::mul_n(a, b)), epx::to_string(epx::mul_n(sa, sb)));
+    auto qr = epx::div_n(a, b);
+    auto sqr = epx::div_n(sa, sb);
+    EXPECT_EQ(epx::to_string(qr.q), epx::to_string(sqr.q));
+    EXPECT_EQ(epx::to_string(qr.r), epx::to_string(sqr.r));
+  }
+  EXPECT_EQ("-123456789012345678901234567890", epx::to_string(stosvz("-123456789012345678901234567890")));
+}
+
+TEST(small_vector_tests, r_series) {
+  auto one = epx::make_q(stosvz("1"), stosvz("1"));
+  auto four = epx::make_q(stosvz("4"), stosvz("1"));
+  auto pi = epx::mul(four, epx::arctan(one));
+  EXPECT_EQ("3.1415926535897932384626433832795028841972", epx::to_string(pi, 40));
+  EXPECT_EQ("2.7182818284590452353602874713526624977572", epx::to_string(epx::exp(one), 40));
+}
+
+}  // namespace epxut
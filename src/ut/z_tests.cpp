@@ -5,7 +5,10 @@
 #include <gtest/gtest.h>
 
 // std
+#include <cmath>
 #include <limits>
+#include <numeric>
+#include <utility>
 
 // epx
 #include "z.hpp"
@@ -300,6 +303,274 @@ TEST(z_tests, ceil_div) {
   }
 }
 
+TEST(z_tests, destination_passing) {
+  auto a = make_digits<mz>(9, 44), b = make_digits<mz>(5, 45);
+  mz na = a, nb = b;
+  epx::negate(na);
+  epx::negate(nb);
+  for (const auto* x : {&a, &na}) {
+    for (const auto* y : {&b, &nb}) {
+      mz dst;
+      EXPECT_EQ(epx::add(*x, *y), epx::add_to(dst, *x, *y));
+      EXPECT_EQ(epx::sub(*x, *y), epx::sub_to(dst, *x, *y));
+      EXPECT_EQ(epx::sub(*y, *x), epx::sub_to(dst, *y, *x));
+      EXPECT_EQ(epx::mul(*x, *y), epx::mul_into(dst, *x, *y));
+
+      // dst aliases an operand
+      dst = *x;
+      EXPECT_EQ(epx::add(*x, *y), epx::add_to(dst, dst, *y));
+      dst = *y;
+      EXPECT_EQ(epx::sub(*x, *y), epx::sub_to(dst, *x, dst));
+      dst = *x;
+      EXPECT_EQ(epx::mul(*x, *y), epx::mul_into(dst, dst, *y));
+      dst = *x;
+      EXPECT_EQ(epx::mul(*x, *x), epx::mul_into(dst, dst, dst));
+
+      dst = *y;
+      EXPECT_EQ(epx::add(*y, epx::mul(*x, *y)), epx::addmul(dst, *x, *y));
+      dst = *y;
+      EXPECT_EQ(epx::sub(*y, epx::mul(*x, *y)), epx::submul(dst, *x, *y));
+      dst = *y;
+      EXPECT_EQ(epx::sub(*y, epx::mul(*y, *y)), epx::submul(dst, dst, dst));
+    }
+  }
+  {
+    mz zero, dst = a;
+    EXPECT_TRUE(epx::is_zero(epx::sub_to(dst, a, a)));
+    EXPECT_EQ(a, epx::add_to(dst, zero, a));
+    EXPECT_TRUE(epx::is_zero(epx::mul_into(dst, a, zero)));
+  }
+  {
+    // the product cancels dst, or outweighs it, and dst keeps its storage throughout
+    mz dst = epx::mul(a, b);
+    dst.digits.reserve(32);
+    const auto* storage = dst.digits.data();
+    EXPECT_TRUE(epx::is_zero(epx::submul(dst, a, b)));
+    EXPECT_EQ(epx::mul(a, b), epx::addmul(dst, a, b));
+    auto nab = epx::mul(a, b);
+    EXPECT_EQ(epx::negate(nab), epx::submul(dst, a, epx::add(b, b)));
+    dst = b;
+    EXPECT_EQ(epx::sub(b, epx::mul(a, a)), epx::addmul(dst, na, a));
+    EXPECT_EQ(storage, dst.digits.data());
+  }
+}
+
+TEST(z_tests, floor_div_into) {
+  auto a = make_digits<mz>(7, 46);
+  for (auto divisor : {make_digits<mz>(1, 47), make_digits<mz>(3, 48)}) {
+    for (auto sa : {epx::sign::positive, epx::sign::negative}) {
+      for (auto sb : {epx::sign::positive, epx::sign::negative}) {
+        mz x = a, y = divisor;
+        x.sgn = sa;
+        y.sgn = sb;
+        auto [eq, er] = epx::floor_div(x, y);
+        epx::normalize(er);
+        mz q, r;
+        epx::floor_div_into(q, r, x, y);
+        EXPECT_EQ(eq, q);
+        EXPECT_EQ(er, r);
+
+        // the quotient overwrites the dividend
+        epx::floor_div_into(x, r, x, y);
+        EXPECT_EQ(eq, x);
+        EXPECT_EQ(er, r);
+
+        // or the divisor
+        x = a;
+        x.sgn = sa;
+        epx::floor_div_into(q, y, x, y);
+        EXPECT_EQ(eq, q);
+        EXPECT_EQ(er, y);
+      }
+    }
+  }
+  {
+    // schoolbook divisions into q and r keep their storage
+    const auto x = make_digits<lz>(40, 49);
+    auto y = make_digits<lz>(12, 50);
+    lz q, r;
+    q.digits.reserve(64);
+    r.digits.reserve(64);
+    const auto* qs = q.digits.data();
+    const auto* rs = r.digits.data();
+    for (int i = 0; i < 2; ++i) {
+      for (auto sb : {epx::sign::positive, epx::sign::negative}) {
+        y.sgn = sb;
+        auto [eq, er] = epx::floor_div(x, y);
+        epx::normalize(eq);
+        epx::normalize(er);
+        epx::floor_div_into(q, r, x, y);
+        EXPECT_EQ(eq, q);
+        EXPECT_EQ(er, r);
+        EXPECT_EQ(qs, q.digits.data());
+        EXPECT_EQ(rs, r.digits.data());
+      }
+      y.digits.back() |= 0x80000000u;  // a divisor that needs no normalizing
+    }
+  }
+  {
+    // Burnikel-Ziegler divisions, also into the dividend and the divisor
+    const auto a = make_digits<lz>(600, 51);
+    for (auto sb : {epx::sign::positive, epx::sign::negative}) {
+      auto x = a, y = make_digits<lz>(260, 52);
+      y.sgn = sb;
+      auto [eq, er] = epx::floor_div(x, y);
+      epx::normalize(eq);
+      epx::normalize(er);
+      lz q, r;
+      epx::floor_div_into(q, r, x, y);
+      EXPECT_EQ(eq, q);
+      EXPECT_EQ(er, r);
+      epx::floor_div_into(x, r, x, y);
+      EXPECT_EQ(eq, x);
+      EXPECT_EQ(er, r);
+      x = a;
+      epx::floor_div_into(q, y, x, y);
+      EXPECT_EQ(eq, q);
+      EXPECT_EQ(er, y);
+    }
+  }
+  {
+    mz q, r, one{.digits = {1}};
+    epx::floor_div_into(q, r, mz{}, one);
+    EXPECT_TRUE(epx::is_zero(q));
+    EXPECT_TRUE(epx::is_zero(r));
+    EXPECT_THROW(epx::floor_div_into(q, r, one, mz{}), epx::divide_by_zero_error);
+  }
+}
+
+template <class Z>
+void check_divisor(const Z& d) {
+  using C = typename Z::container_type;
+  const auto n = std::ranges::size(d.digits);
+  for (size_t un : {0uz, n - 1, n, 2 * n + 3, 3 * n + 1}) {
+    for (auto sd : {epx::sign::positive, epx::sign::negative}) {
+      Z y = d;
+      y.sgn = sd;
+      const epx::divisor<C> dv(y);
+      for (auto sa : {epx::sign::positive, epx::sign::negative}) {
+        Z x = make_digits<Z>(un, static_cast<uint32_t>(un + 53));
+        if (!epx::is_zero(x)) x.sgn = sa;
+        auto [eq, er] = epx::floor_div(x, y);
+        epx::normalize(eq);
+        epx::normalize(er);
+        auto [q, r] = epx::floor_div(x, dv);
+        EXPECT_EQ(eq, q);
+        EXPECT_EQ(er, r);
+        epx::floor_div_into(x, r, x, dv);
+        EXPECT_EQ(eq, x);
+        EXPECT_EQ(er, r);
+      }
+    }
+  }
+  auto [q, r] = epx::floor_div(d, epx::divisor<C>(d));
+  EXPECT_EQ(epx::details::one<C>(), q);
+  EXPECT_TRUE(epx::is_zero(r));
+}
+
+TEST(z_tests, divisor) {
+  // single digit, powers of two, schoolbook and Burnikel-Ziegler sizes
+  for (size_t n : {1uz, 3uz, 70uz, 300uz}) {
+    check_divisor(make_digits<sz>(n, 54));
+    check_divisor(make_digits<lz>(n, 55));
+    check_divisor(epx::mul_2exp(lz{.digits = {1}}, static_cast<int>(32 * n - 27)));
+    check_divisor(make_digits<hz>(n, 56));
+  }
+  check_divisor(sz{.digits = {7}});
+  check_divisor(sz{.digits = {0, 0, 1}});
+  check_divisor(lz{.digits = {0, 0x80}});
+  EXPECT_THROW(epx::divisor<sz::container_type>(sz{}), epx::divide_by_zero_error);
+}
+
+template <class Z>
+void check_prepared_multiplier(const Z& v) {
+  using C = typename Z::container_type;
+  const auto n = std::ranges::size(v.digits);
+  const epx::prepared_multiplier<C> m(v);
+  // the transform lengths change between these sizes, and back
+  for (size_t an : {0uz, 5uz, n, 3 * n, n + 1}) {
+    Z x = make_digits<Z>(an, static_cast<uint32_t>(an + 71));
+    if (an % 2 == 1) epx::negate(x);
+    const auto expected = epx::mul(x, v);
+    EXPECT_EQ(expected, epx::mul(x, m));
+    EXPECT_EQ(expected, epx::mul(x, m));  // with the cached transform
+    Z h;
+    epx::details::mul_high_into(h, x, m, static_cast<int>(an * 4));
+    EXPECT_LE(epx::cmp_n(h, epx::mul_2exp(expected, -static_cast<int>(an * 4))), 0);
+    epx::mul_into(x, x, m);
+    EXPECT_EQ(expected, x);
+  }
+}
+
+TEST(z_tests, prepared_multiplier) {
+  check_prepared_multiplier(make_digits<sz>(30, 72));
+  check_prepared_multiplier(make_digits<lz>(2100, 73));
+  auto v = make_digits<sz>(2048, 74);
+  epx::negate(v);
+  check_prepared_multiplier(v);
+}
+
+template <class Z>
+void check_scalar_ops(const Z& a) {
+  using C = typename Z::container_type;
+  for (long long v : {1ll, 7ll, 255ll, 1000ll, 70000ll, 0xffffffffll, -3ll, -256ll, -123456789ll}) {
+    const auto zv = epx::create<C>(v);
+    Z dst;
+    EXPECT_EQ(epx::mul(a, zv), epx::mul_si(dst, a, v));
+    auto [eq, er] = epx::floor_div(a, zv);
+    epx::normalize(eq);
+    epx::normalize(er);
+    EXPECT_EQ(er, epx::create<C>(epx::floor_div_si(dst, a, v)));
+    EXPECT_EQ(eq, dst);
+    dst = a;
+    epx::floor_div_si(dst, dst, v);
+    EXPECT_EQ(eq, dst);
+    if (v < 0) continue;
+
+    const auto uv = static_cast<unsigned long long>(v);
+    dst = a;
+    EXPECT_EQ(epx::mul(a, zv), epx::mul_ui(dst, dst, uv));
+    EXPECT_EQ(er, epx::create<C>(epx::floor_div_ui(dst, a, uv)));
+    EXPECT_EQ(eq, dst);
+    auto [tq, tr] = epx::div(a, zv);
+    epx::normalize(tq);
+    epx::normalize(tr);
+    EXPECT_EQ(tr.digits, epx::create<C>(epx::div_ui(dst, a, uv)).digits);
+    EXPECT_EQ(tq, dst);
+    for (const auto& acc : {Z{}, a, epx::mul_2exp(a, 3), make_digits<Z>(2, 50)}) {
+      for (auto sacc : {epx::sign::positive, epx::sign::negative}) {
+        Z d = acc;
+        if (sacc == epx::sign::negative) epx::negate(d);
+        const Z start = d;
+        EXPECT_EQ(epx::add(start, epx::mul(a, zv)), epx::addmul_ui(d, a, uv));
+        d = start;
+        EXPECT_EQ(epx::sub(start, epx::mul(a, zv)), epx::submul_ui(d, a, uv));
+      }
+    }
+    dst = a;
+    EXPECT_EQ(epx::sub(a, epx::mul(a, zv)), epx::submul_ui(dst, dst, uv));
+  }
+  Z dst = a;
+  EXPECT_TRUE(epx::is_zero(epx::mul_ui(dst, a, 0u)));
+  dst = a;
+  EXPECT_TRUE(epx::is_zero(epx::submul_ui(dst, a, 1u)));
+  EXPECT_THROW(epx::floor_div_ui(dst, a, 0u), epx::divide_by_zero_error);
+  EXPECT_THROW(epx::floor_div_si(dst, a, 0), epx::divide_by_zero_error);
+}
+
+TEST(z_tests, scalar_ops) {
+  for (auto sa : {epx::sign::positive, epx::sign::negative}) {
+    for (size_t n : {0uz, 1uz, 9uz}) {
+      auto s = make_digits<sz>(n, 51);
+      auto l = make_digits<lz>(n, 52);
+      if (!epx::is_zero(s)) s.sgn = sa;
+      if (!epx::is_zero(l)) l.sgn = sa;
+      check_scalar_ops(s);
+      check_scalar_ops(l);
+    }
+  }
+}
+
 TEST(z_tests, mul_4exp) {
   {
     sz num{.digits = {1, 2, 3}};
@@ -341,6 +612,30 @@ TEST(z_tests, mul_4exp) {
   }
 }
 
+template <class Z>
+void check_mul_2exp(const Z& a) {
+  using C = typename Z::container_type;
+  for (int e = -3 * 64; e <= 3 * 64; e += 7) {
+    const auto p = epx::pow(epx::create<C>(2), std::abs(e));
+    auto expected = e >= 0 ? epx::mul(a, p) : epx::div_n(a, p).q;
+    if (!epx::is_zero(expected)) expected.sgn = a.sgn;
+    EXPECT_EQ(expected, epx::mul_2exp(a, e)) << e;
+    Z b = a;
+    EXPECT_EQ(expected, epx::mul_2exp(b, e)) << e;
+  }
+}
+
+TEST(z_tests, mul_2exp) {
+  // whole-digit and partial shifts both ways, in place and into a new value
+  check_mul_2exp(make_digits<sz>(5, 77));
+  check_mul_2exp(make_digits<lz>(4, 78));
+  auto a = make_digits<mz>(9, 79);
+  epx::negate(a);
+  check_mul_2exp(a);
+  check_mul_2exp(sz{.digits = {0x80}});
+  check_mul_2exp(sz{});
+}
+
 TEST(z_tests, pow) {
   {
     sz zero;
@@ -365,6 +660,34 @@ TEST(z_tests, pow) {
     EXPECT_EQ(minus_one, epx::pow(minus_one, 9));  // (-1)^9 = -1
     EXPECT_EQ(one, epx::pow(minus_one, 10));       // (-1)^10 = 1
   }
+  {
+    // Every window width, against repeated multiplication.
+    auto num = make_digits<lz>(3, 57);
+    num.sgn = epx::sign::negative;
+    lz expected = {.digits = {1}};
+    for (int exp = 0; exp <= 300; ++exp) {
+      EXPECT_EQ(expected, epx::pow(num, exp));
+      expected = epx::mul(expected, num);
+    }
+    EXPECT_EQ(epx::pow(epx::pow(num, 1 << 5), 1 << 5), epx::pow(num, 1 << 10));
+    lz two = {.digits = {2}, .sgn = epx::sign::negative};
+    auto big = epx::mul_2exp(lz{.digits = {1}}, (1 << 16) + 5);
+    EXPECT_EQ(epx::negate(big), epx::pow(two, (1 << 16) + 5));
+  }
+}
+
+TEST(z_tests, pow_ui) {
+  for (unsigned long long base : {0ull, 1ull, 2ull, 10ull, 12ull, 255ull, 65536ull, 0xfffffffbull, 0xffffffffffffffffull}) {
+    for (unsigned exp : {0u, 1u, 2u, 7u, 64u, 333u}) {
+      EXPECT_EQ(epx::pow(epx::create<sz::container_type>(base), static_cast<int>(exp)),
+                epx::pow_ui<sz::container_type>(base, exp));
+      EXPECT_EQ(epx::pow(epx::create<lz::container_type>(base), static_cast<int>(exp)),
+                epx::pow_ui<lz::container_type>(base, exp));
+    }
+  }
+  EXPECT_EQ("1" + std::string(100, '0'), epx::to_string(epx::pow_ui<lz::container_type>(10u, 100)));
+  // the final shift, 41 * 2^26 bits, does not fit in an int
+  EXPECT_THROW(epx::pow_ui<lz::container_type>(2ull << 40, 1u << 26), epx::precision_overflow_error);
 }
 
 TEST(z_tests, root) {
@@ -397,6 +720,103 @@ TEST(z_tests, root) {
   }
 }
 
+TEST(z_tests, root_large) {
+  for (int k : {3, 5, 17, 64}) {
+    for (size_t n : {1uz, 4uz, 30uz, 90uz}) {
+      const auto num = make_digits<lz>(n * static_cast<size_t>(k), static_cast<uint32_t>(61 + k));
+      const auto x = epx::root(num, k);
+      EXPECT_LE(epx::cmp_n(epx::pow(x, k), num), 0);
+      EXPECT_GT(epx::cmp_n(epx::pow(epx::add_n(x, lz{.digits = {1}}), k), num), 0);
+      const auto a = make_digits<lz>(n, 62);
+      EXPECT_EQ(a, epx::root(epx::pow(a, k), k));
+      EXPECT_EQ(epx::sub_n(a, lz{.digits = {1}}), epx::root(epx::sub_n(epx::pow(a, k), lz{.digits = {1}}), k));
+    }
+  }
+}
+
+TEST(z_tests, sqrtrem) {
+  for (int v = 0; v < 2000; ++v) {
+    auto [s, r] = epx::sqrtrem(create_sz(v));
+    const int sv = static_cast<int>(std::sqrt(v));
+    EXPECT_EQ(create_sz(sv), s);
+    EXPECT_EQ(create_sz(v - sv * sv), r);
+  }
+  auto check = []<class Z>(const Z& num) {
+    auto [s, r] = epx::sqrtrem(num);
+    EXPECT_EQ(num, epx::add(epx::sqr(s), r));
+    EXPECT_FALSE(epx::is_negative(r));
+    EXPECT_LE(epx::cmp_n(r, epx::add_n(s, s)), 0);  // num < (s + 1)^2
+    EXPECT_EQ(s, epx::details::root_newton(num, 2));
+  };
+  for (size_t n : {1uz, 2uz, 3uz, 9uz, 40uz, 129uz}) {
+    check(make_digits<sz>(n, 58));
+    check(make_digits<lz>(n, 59));
+    auto sq = epx::sqr(make_digits<lz>(n, 60));
+    check(sq);
+    check(epx::sub_n(sq, lz{.digits = {1}}));  // one less than a square: the remainder is 2s
+    EXPECT_TRUE(epx::is_zero(epx::sqrtrem(sq).r));
+  }
+  check(lz{.digits = lz::container_type(50, 0xffffffff)});
+  EXPECT_THROW(epx::sqrtrem(create_sz(-4)), epx::negative_radicand_error);
+}
+
+template <class Z>
+void check_gcd(const Z& a, const Z& b, const Z& expected) {
+  EXPECT_EQ(expected, epx::gcd(a, b));
+  auto [g, s, t] = epx::gcdext(a, b);
+  EXPECT_EQ(expected, g);
+  EXPECT_EQ(g, epx::add(epx::mul(a, s), epx::mul(b, t)));
+  if (!epx::is_zero(b) && !epx::is_zero(g)) {
+    EXPECT_LE(epx::cmp_n(epx::mul_n(epx::add_n(s, s), g), b), 0);  // |s| <= |b| / 2g
+  }
+}
+
+TEST(z_tests, gcd) {
+  for (int a = -30; a <= 30; ++a) {
+    for (int b = -30; b <= 30; ++b) {
+      check_gcd(create_sz(a), create_sz(b), create_sz(std::gcd(a, b)));
+      EXPECT_EQ(create_sz(std::lcm(a, b)), epx::lcm(create_sz(a), create_sz(b)));
+    }
+  }
+  auto euclid = []<class Z>(Z a, Z b) {
+    while (!epx::is_zero(b)) {
+      auto r = epx::div_n(a, b).r;
+      a = std::exchange(b, std::move(r));
+    }
+    return a;
+  };
+  // Lehmer steps, then half-GCD reductions from hgcd_threshold digits on.
+  for (size_t n : {1uz, 3uz, 20uz, 150uz, 300uz}) {
+    for (size_t m : {0uz, 1uz, n / 2 + 1}) {
+      const auto c = make_digits<lz>(m, 63) + lz{.digits = {1}};
+      const auto x = epx::mul(c, make_digits<lz>(n, 64)), y = epx::mul(c, make_digits<lz>(n + n / 3, 65));
+      check_gcd(x, y, euclid(x, y));
+      auto ny = y;
+      check_gcd(epx::negate(ny), x, euclid(x, y));
+      const auto sx = make_digits<sz>(n, 66), sy = make_digits<sz>(n, 67);
+      check_gcd(sx, sy, euclid(sx, sy));
+    }
+  }
+  {
+    // Consecutive Fibonacci numbers: every quotient is 1.
+    lz f0, f1 = {.digits = {1}};
+    for (int i = 0; i < 20000; ++i) f0 = epx::add_n(f0, f1), std::swap(f0, f1);
+    check_gcd(f1, f0, lz{.digits = {1}});
+    const auto g = make_digits<lz>(50, 68);
+    check_gcd(epx::mul(f1, g), epx::mul(f0, g), g);
+  }
+  {
+    // The GCD is most of the pair, which stops reducing well above the half-GCD bound.
+    const auto a = make_digits<lz>(1000, 69);
+    check_gcd(a, a, a);
+    check_gcd(a, epx::mul_2exp(a, 1), a);
+    const auto p = epx::mul_2exp(lz{.digits = {1}}, 30000);
+    check_gcd(epx::mul_2exp(lz{.digits = {3}}, 30000), epx::mul_2exp(lz{.digits = {5}}, 30000), p);
+  }
+  EXPECT_EQ(create_sz(60), epx::lcm(create_sz(-12), create_sz(20)));
+  EXPECT_TRUE(epx::is_zero(epx::lcm(sz{}, create_sz(5))));
+}
+
 // Generated by AI (Claude Opus 4.6) — Additional tests for improving code coverage
 
 TEST(z_tests, root_negative_radicand) {
@@ -601,4 +1021,31 @@ TEST(z_tests, mz_root) {
   EXPECT_EQ(stomz("4641588"), epx::root(stomz("99999999999999999999"), 3));    // floor(cbrt(~10^20))
 }
 
+TEST(z_tests, hz_arith) {
+  // Test 64-bit digits, whose products and divisions go through umul and div_2d
+  auto stohz = [](std::string_view s) { return epx::try_from_chars<hz::container_type>(s).value(); };
+  {
+    hz a = {.digits = {0xffffffffffffffff}}, b = {.digits = {0xffffffffffffffff}};
+    hz expected = {.digits = {1, 0xfffffffffffffffe}};  // (2^64 - 1)^2
+    EXPECT_EQ(expected, epx::mul(a, b));
+  }
+  {
+    auto u = stohz("340282366920938463463374607431768211457");  // 2^128 + 1
+    auto v = stohz("18446744073709551629");                     // 2^64 + 13
+    auto [q, r] = epx::floor_div(u, v);
+    EXPECT_EQ(stohz("18446744073709551603"), q);
+    EXPECT_EQ(stohz("170"), r);
+    EXPECT_EQ("340282366920938463463374607431768211457", epx::to_string(u));
+  }
+  {
+    hz num{.digits = {1}};
+    epx::mul_4exp(num, 40);  // 2^80
+    EXPECT_EQ((hz{.digits = {0, 0x10000}}), num);
+    epx::mul_2exp(num, -79);
+    EXPECT_EQ(hz{.digits = {2}}, num);
+  }
+  EXPECT_EQ(stohz("4294967296"), epx::root(stohz("18446744073709551616"), 2));  // sqrt(2^64) = 2^32
+  EXPECT_EQ(stohz("4641588"), epx::root(stohz("99999999999999999999"), 3));     // floor(cbrt(~10^20))
+}
+
 }  // namespace epxut